@@ -16,6 +16,80 @@
  */
 
 #include "ai/Goal.h"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include "message/MessageBusStatistics.h"
+
+namespace
+{
+
+constexpr std::size_t POOL_GRANULARITY = alignof(std::max_align_t);
+constexpr std::size_t NB_POOLS = 16;
+
+// A free block stores the next free block of the same size
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+// Lists of the blocks left by the threads that exited, the other threads take them by batches
+constexpr std::size_t SHARED_BATCH_SIZE = 64;
+std::mutex sharedMutex;
+std::array<FreeBlock*, NB_POOLS> sharedFreeBlocks{};
+std::array<std::atomic<bool>, NB_POOLS> hasSharedFreeBlocks{}; // Avoid locking when there is nothing to take
+
+// One list per size, per thread so that no lock is needed
+struct FreeBlocks
+{
+    std::array<FreeBlock*, NB_POOLS> heads{};
+
+    // Give the blocks to the other threads when the thread exits, otherwise they are lost
+    ~FreeBlocks()
+    {
+        std::lock_guard<std::mutex> lock(sharedMutex);
+        for (std::size_t pool = 0; pool < NB_POOLS; ++pool)
+        {
+            if (!heads[pool])
+                continue;
+            FreeBlock* tail = heads[pool];
+            while (tail->next)
+                tail = tail->next;
+            tail->next = sharedFreeBlocks[pool];
+            sharedFreeBlocks[pool] = heads[pool];
+            hasSharedFreeBlocks[pool].store(true, std::memory_order_relaxed);
+        }
+    }
+};
+
+thread_local FreeBlocks freeBlocks;
+
+// Only counted if MESSAGE_STATISTICS is defined
+std::atomic<unsigned long long> nbAllocations(0);
+std::atomic<unsigned long long> nbHeapAllocations(0);
+
+std::size_t computePool(std::size_t size)
+{
+    return (size + POOL_GRANULARITY - 1) / POOL_GRANULARITY - 1;
+}
+
+FreeBlock* takeSharedFreeBlocks(std::size_t pool)
+{
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    FreeBlock* head = sharedFreeBlocks[pool];
+    if (!head)
+        return nullptr;
+    FreeBlock* tail = head;
+    for (std::size_t i = 1; i < SHARED_BATCH_SIZE && tail->next; ++i)
+        tail = tail->next;
+    sharedFreeBlocks[pool] = tail->next;
+    hasSharedFreeBlocks[pool].store(sharedFreeBlocks[pool] != nullptr, std::memory_order_relaxed);
+    tail->next = nullptr;
+    return head;
+}
+
+}
 
 Goal::Goal(Person* owner) : mOwner(owner), mState(State::INACTIVE)
 {
@@ -59,7 +133,7 @@ bool Goal::hasFailed() const
 
 void Goal::pushFront(std::unique_ptr<Goal>&& goal)
 {
-    mSubgoals.emplace_front(std::move(goal));
+    mSubgoals.emplace(mSubgoals.begin(), std::move(goal));
 }
 
 void Goal::pushBack(std::unique_ptr<Goal>&& goal)
@@ -94,7 +168,7 @@ Goal::State Goal::processSubgoals()
     while (!mSubgoals.empty() && mSubgoals.front()->process() == State::COMPLETED)
     {
         mSubgoals.front()->terminate();
-        mSubgoals.pop_front();
+        mSubgoals.erase(mSubgoals.begin());
     }
     return mSubgoals.empty() ? State::COMPLETED : mSubgoals.front()->getState();
 }
@@ -110,3 +184,56 @@ std::string Goal::toString() const
 {
     return "";
 }
+
+void* Goal::operator new(std::size_t size)
+{
+#ifdef MESSAGE_STATISTICS
+    nbAllocations.fetch_add(1, std::memory_order_relaxed);
+#endif
+    std::size_t pool = computePool(size);
+    if (pool < NB_POOLS)
+    {
+        FreeBlock*& head = freeBlocks.heads[pool];
+        if (!head && hasSharedFreeBlocks[pool].load(std::memory_order_relaxed))
+            head = takeSharedFreeBlocks(pool);
+        if (head)
+        {
+            FreeBlock* block = head;
+            head = block->next;
+            return block;
+        }
+    }
+#ifdef MESSAGE_STATISTICS
+    nbHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+#endif
+    // Round the size so that the block can be reused by any goal of the same pool
+    return ::operator new(pool < NB_POOLS ? (pool + 1) * POOL_GRANULARITY : size);
+}
+
+void Goal::operator delete(void* pointer, std::size_t size)
+{
+    std::size_t pool = computePool(size);
+    if (pool < NB_POOLS)
+    {
+        FreeBlock* block = new (pointer) FreeBlock{freeBlocks.heads[pool]};
+        freeBlocks.heads[pool] = block;
+    }
+    else
+        ::operator delete(pointer);
+}
+
+unsigned long long Goal::getNbAllocations()
+{
+    return nbAllocations.load(std::memory_order_relaxed);
+}
+
+unsigned long long Goal::getNbHeapAllocations()
+{
+    return nbHeapAllocations.load(std::memory_order_relaxed);
+}
+
+void Goal::resetAllocationCounters()
+{
+    nbAllocations.store(0, std::memory_order_relaxed);
+    nbHeapAllocations.store(0, std::memory_order_relaxed);
+}
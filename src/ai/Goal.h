@@ -17,7 +17,9 @@
 
 #pragma once
 
-#include <deque>
+#include <cstddef>
+#include <memory>
+#include <vector>
 #include <boost/serialization/access.hpp>
 #include "util/NonCopyable.h"
 #include "util/NonMovable.h"
@@ -52,10 +54,19 @@ public:
 
     virtual std::string toString() const;
 
+    // Memory of the goals is recycled in one pool per size
+    static void* operator new(std::size_t size);
+    static void operator delete(void* pointer, std::size_t size);
+
+    // Number of goals allocated and number of them that needed a heap allocation, always 0 if MESSAGE_STATISTICS is not defined
+    static unsigned long long getNbAllocations();
+    static unsigned long long getNbHeapAllocations();
+    static void resetAllocationCounters();
+
 protected:
     Person* mOwner;
     State mState;
-    std::deque<std::unique_ptr<Goal>> mSubgoals;
+    std::vector<std::unique_ptr<Goal>> mSubgoals; // Contrary to a deque, an empty vector does not allocate
 
     Goal() = default; // Only for serialization
 
@@ -0,0 +1,108 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ai/GoalArbiter.h"
+#include <limits>
+#include "ai/GoalShopEvaluator.h"
+#include "city/Person.h"
+#include "city/Work.h"
+
+TaskScheduler::TaskId GoalArbiter::addTasks(TaskScheduler& scheduler, const std::vector<Person*>& persons, TaskScheduler::TaskId dependency)
+{
+    TaskScheduler::TaskId selection = scheduler.addTask("arbitration selection",
+        [this, &persons]{ select(persons); }, {dependency});
+    TaskScheduler::TaskId inputs = scheduler.addParallelTask("arbitration inputs",
+        [this]{ return mInputs.size; }, CHUNK_SIZE,
+        [this](std::size_t begin, std::size_t end){ gather(begin, end); }, {selection});
+    TaskScheduler::TaskId evaluation = scheduler.addParallelTask("arbitration evaluation",
+        [this]{ return mInputs.size > 0 ? static_cast<std::size_t>(GoalEvaluator::Type::COUNT) : 0; }, 1,
+        [this](std::size_t begin, std::size_t end){ evaluate(begin, end); }, {inputs});
+    return scheduler.addTask("arbitration dispatch", [this]{ dispatch(); }, {evaluation});
+}
+
+void GoalArbiter::select(const std::vector<Person*>& persons)
+{
+    mPersons.clear();
+    mBrains.clear();
+    for (Person* person : persons)
+    {
+        // Only the short term brains are arbitrated in batch
+        if (person->getShortTermBrain().isArbitrationPending())
+        {
+            mPersons.push_back(person);
+            mBrains.push_back(&person->getShortTermBrain());
+        }
+    }
+
+    mInputs.resize(mBrains.size());
+    mDesirabilities.resize(static_cast<int>(GoalEvaluator::Type::COUNT) * mInputs.size);
+}
+
+void GoalArbiter::gather(std::size_t begin, std::size_t end)
+{
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        Person* person = mPersons[i];
+        const GoalThink* brain = mBrains[i];
+        bool hasHome = person->getHome() != nullptr;
+        mInputs.hasHome[i] = hasHome;
+        mInputs.hasWorkToDo[i] = person->getWork() && !person->getWork()->hasWorkedThisMonth();
+        // Only look for a shop if the brain uses the shop evaluator
+        bool usesShop = brain->getFirstEvaluator() <= GoalEvaluator::Type::SHOP && GoalEvaluator::Type::SHOP < brain->getLastEvaluator();
+        mInputs.hasShopAvailable[i] = usesShop && hasHome && person->getAccountBalance() >= 0.0 &&
+            GoalShopEvaluator::isShopAvailable(person);
+        mInputs.energy[i] = person->getNeed(Person::Need::ENERGY);
+        mInputs.satiety[i] = person->getNeed(Person::Need::SATIETY);
+        mInputs.happiness[i] = person->getNeed(Person::Need::HAPPINESS);
+        mInputs.averageEnergy[i] = person->getAverageNeed(Person::Need::ENERGY);
+        mInputs.lastMonthOutcome[i] = person->getLastMonthOutcome();
+        for (int j = 0; j < static_cast<int>(GoalEvaluator::Type::COUNT); ++j)
+            mInputs.biases[j][i] = person->getBias(static_cast<GoalEvaluator::Type>(j));
+    }
+}
+
+void GoalArbiter::evaluate(std::size_t firstEvaluator, std::size_t lastEvaluator)
+{
+    std::size_t size = mInputs.size;
+    for (std::size_t j = firstEvaluator; j < lastEvaluator; ++j)
+    {
+        const GoalEvaluator& evaluator = GoalEvaluator::get(static_cast<GoalEvaluator::Type>(j));
+        evaluator.computeDesirabilities(mInputs, mInputs.biases[j].data(), mDesirabilities.data() + j * size);
+    }
+}
+
+void GoalArbiter::dispatch()
+{
+    std::size_t size = mInputs.size;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        GoalThink* brain = mBrains[i];
+        float maxDesirability = std::numeric_limits<float>::lowest();
+        const GoalEvaluator* bestEvaluator = nullptr;
+        for (int j = static_cast<int>(brain->getFirstEvaluator()); j < static_cast<int>(brain->getLastEvaluator()); ++j)
+        {
+            float desirability = mDesirabilities[j * size + i];
+            if (desirability > maxDesirability)
+            {
+                maxDesirability = desirability;
+                bestEvaluator = &GoalEvaluator::get(static_cast<GoalEvaluator::Type>(j));
+            }
+        }
+        brain->setGoal(maxDesirability > 0.0f ? bestEvaluator : nullptr);
+    }
+}
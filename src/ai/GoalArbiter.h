@@ -0,0 +1,49 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <vector>
+#include "ai/GoalEvaluator.h"
+#include "util/TaskScheduler.h"
+
+class Person;
+class GoalThink;
+
+// Arbitrates the pending short term brains of many persons at once
+// The inputs of the evaluators are gathered in arrays so that each evaluator runs on the whole batch
+class GoalArbiter
+{
+public:
+    // Add the tasks of the arbitration after dependency, the last task is returned
+    // The inputs are gathered and the evaluators run in parallel, the goals are set serially
+    TaskScheduler::TaskId addTasks(TaskScheduler& scheduler, const std::vector<Person*>& persons, TaskScheduler::TaskId dependency);
+
+private:
+    static constexpr std::size_t CHUNK_SIZE = 256;
+
+    std::vector<Person*> mPersons;
+    std::vector<GoalThink*> mBrains;
+    GoalEvaluator::Inputs mInputs;
+    std::vector<float> mDesirabilities; // One column per evaluator type
+
+    void select(const std::vector<Person*>& persons);
+    void gather(std::size_t begin, std::size_t end);
+    void evaluate(std::size_t firstEvaluator, std::size_t lastEvaluator);
+    void dispatch();
+};
@@ -16,23 +16,33 @@
  */
 
 #include "ai/GoalEnterCityEvaluator.h"
+#include <algorithm>
 #include "city/Person.h"
 #include "ai/GoalEnterCity.h"
 
-GoalEnterCityEvaluator::GoalEnterCityEvaluator(float bias) : GoalEvaluator(bias), mAlreadySelected(false)
+GoalEnterCityEvaluator::GoalEnterCityEvaluator() : mAlreadySelected(false)
 {
     //ctor
 }
 
-float GoalEnterCityEvaluator::computeDesirability(Person* /*person*/)
+float GoalEnterCityEvaluator::computeDesirability(Person* /*person*/, float bias) const
 {
-    if (!mAlreadySelected)
-        return mBias;
-    return 0.0f;
+    return bias;
 }
 
-void GoalEnterCityEvaluator::setGoal(Person* person)
+void GoalEnterCityEvaluator::computeDesirabilities(const Inputs& inputs, const float* biases, float* desirabilities) const
 {
-    mAlreadySelected = true;
+    std::copy(biases, biases + inputs.size, desirabilities);
+}
+
+void GoalEnterCityEvaluator::setGoal(Person* person) const
+{
+    // The goal is selected only once
+    person->setBias(GoalEvaluator::Type::ENTER_CITY, 0.0f);
     person->getLongTermBrain().pushFront(std::make_unique<GoalEnterCity>(person));
 }
+
+float GoalEnterCityEvaluator::getLegacyBias() const
+{
+    return mAlreadySelected ? 0.0f : mLegacyBias;
+}
@@ -23,11 +23,14 @@
 class GoalEnterCityEvaluator : public GoalEvaluator
 {
 public:
-    GoalEnterCityEvaluator(float bias);
+    GoalEnterCityEvaluator();
 
-    virtual float computeDesirability(Person* person) override;
+    virtual float computeDesirability(Person* person, float bias) const override;
+    virtual void computeDesirabilities(const Inputs& inputs, const float* biases, float* desirabilities) const override;
 
-    virtual void setGoal(Person* person) override;
+    virtual void setGoal(Person* person) const override;
+
+    virtual float getLegacyBias() const override;
 
 private:
     bool mAlreadySelected;
@@ -35,8 +38,6 @@ private:
     // Serialization
     friend class boost::serialization::access;
 
-    GoalEnterCityEvaluator() = default;
-
     template<typename Archive>
     void serialize(Archive& ar, const unsigned int /*version*/)
     {
@@ -16,8 +16,49 @@
  */
 
 #include "ai/GoalEvaluator.h"
+#include <array>
+#include "ai/GoalEnterCityEvaluator.h"
+#include "ai/GoalGetBetterHomeEvaluator.h"
+#include "ai/GoalGetBetterWorkEvaluator.h"
+#include "ai/GoalLeaveCityEvaluator.h"
+#include "ai/GoalRestEvaluator.h"
+#include "ai/GoalShopEvaluator.h"
+#include "ai/GoalWorkEvaluator.h"
 
-GoalEvaluator::GoalEvaluator(float bias) : mBias(bias)
+namespace
+{
+
+const GoalRestEvaluator restEvaluator;
+const GoalWorkEvaluator workEvaluator;
+const GoalShopEvaluator shopEvaluator;
+const GoalEnterCityEvaluator enterCityEvaluator;
+const GoalLeaveCityEvaluator leaveCityEvaluator;
+const GoalGetBetterHomeEvaluator getBetterHomeEvaluator;
+const GoalGetBetterWorkEvaluator getBetterWorkEvaluator;
+
+// Indexed by GoalEvaluator::Type
+const std::array<const GoalEvaluator*, static_cast<int>(GoalEvaluator::Type::COUNT)> evaluators{
+    &restEvaluator, &workEvaluator, &shopEvaluator, &enterCityEvaluator,
+    &leaveCityEvaluator, &getBetterHomeEvaluator, &getBetterWorkEvaluator};
+
+}
+
+void GoalEvaluator::Inputs::resize(std::size_t newSize)
+{
+    size = newSize;
+    hasHome.resize(size);
+    hasWorkToDo.resize(size);
+    hasShopAvailable.resize(size);
+    energy.resize(size);
+    satiety.resize(size);
+    happiness.resize(size);
+    averageEnergy.resize(size);
+    lastMonthOutcome.resize(size);
+    for (std::vector<float>& typeBiases : biases)
+        typeBiases.resize(size);
+}
+
+GoalEvaluator::GoalEvaluator() : mLegacyBias(0.0f)
 {
 
 }
@@ -27,7 +68,12 @@ GoalEvaluator::~GoalEvaluator()
 
 }
 
-void GoalEvaluator::setBias(float bias)
+const GoalEvaluator& GoalEvaluator::get(Type type)
+{
+    return *evaluators[static_cast<int>(type)];
+}
+
+float GoalEvaluator::getLegacyBias() const
 {
-    mBias = bias;
+    return mLegacyBias;
 }
@@ -17,34 +17,63 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <vector>
 #include <boost/serialization/access.hpp>
 #include "util/NonCopyable.h"
 #include "util/NonMovable.h"
 
 class Person;
 
+// Evaluators are stateless and shared by all the persons, the biases are stored in the persons
 class GoalEvaluator : public NonCopyable, public NonMovable
 {
 public:
-    GoalEvaluator(float bias);
+    // Order of the evaluators in the brains
+    enum class Type : int {REST = 0, WORK, SHOP, ENTER_CITY, LEAVE_CITY, GET_BETTER_HOME, GET_BETTER_WORK, COUNT};
+
+    // Inputs of the evaluators for a batch of persons, one element per person
+    struct Inputs
+    {
+        std::size_t size = 0;
+        std::vector<unsigned char> hasHome;
+        std::vector<unsigned char> hasWorkToDo;
+        std::vector<unsigned char> hasShopAvailable; // Also requires a home and a positive balance
+        std::vector<float> energy;
+        std::vector<float> satiety;
+        std::vector<float> happiness;
+        std::vector<float> averageEnergy;
+        std::vector<float> lastMonthOutcome;
+        std::array<std::vector<float>, static_cast<int>(Type::COUNT)> biases;
+
+        void resize(std::size_t newSize);
+    };
+
+    GoalEvaluator();
     virtual ~GoalEvaluator();
 
-    void setBias(float bias);
-    virtual float computeDesirability(Person* person) = 0;
-    virtual void setGoal(Person* person) = 0;
+    static const GoalEvaluator& get(Type type);
 
-protected:
-    float mBias;
+    virtual float computeDesirability(Person* person, float bias) const = 0;
+    // Must give the same results as computeDesirability
+    virtual void computeDesirabilities(const Inputs& inputs, const float* biases, float* desirabilities) const = 0;
+    virtual void setGoal(Person* person) const = 0;
+
+    // Old saves contain one evaluator per person with its bias
+    virtual float getLegacyBias() const;
 
-    GoalEvaluator() = default; // Only for serialization
+protected:
+    float mLegacyBias;
 
 private:
     // Serialization
     friend class boost::serialization::access;
 
+    // Only used to load old saves
     template<typename Archive>
     void serialize(Archive& ar, const unsigned int /*version*/)
     {
-        ar & mBias;
+        ar & mLegacyBias;
     }
 };
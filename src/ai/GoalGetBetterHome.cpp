@@ -43,7 +43,7 @@ Goal::State GoalGetBetterHome::process()
     if (!isCompleted())
     {
         const Lease* home = mOwner->getHome();
-        sf::Vector2i carCoords = mOwner->getCity()->toTileIndices(mOwner->getCar().getKinematic().getPosition());
+        sf::Vector2i carCoords = mOwner->getCity()->toTileIndices(mOwner->getPosition());
         const Tile* tile = mOwner->getCity()->getMap().getTile(carCoords.y, carCoords.x);
         for (const Market<Lease>::Item* item : mMarket->getItems())
         {
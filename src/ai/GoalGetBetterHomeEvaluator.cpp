@@ -19,17 +19,23 @@
 #include "city/Person.h"
 #include "ai/GoalGetBetterHome.h"
 
-GoalGetBetterHomeEvaluator::GoalGetBetterHomeEvaluator(float bias) : GoalEvaluator(bias)
+GoalGetBetterHomeEvaluator::GoalGetBetterHomeEvaluator()
 {
     //ctor
 }
 
-float GoalGetBetterHomeEvaluator::computeDesirability(Person* person)
+float GoalGetBetterHomeEvaluator::computeDesirability(Person* person, float bias) const
 {
-    return mBias * (1 - person->getAverageNeed(Person::Need::ENERGY));
+    return bias * (1 - person->getAverageNeed(Person::Need::ENERGY));
 }
 
-void GoalGetBetterHomeEvaluator::setGoal(Person* person)
+void GoalGetBetterHomeEvaluator::computeDesirabilities(const Inputs& inputs, const float* biases, float* desirabilities) const
+{
+    for (std::size_t i = 0; i < inputs.size; ++i)
+        desirabilities[i] = biases[i] * (1 - inputs.averageEnergy[i]);
+}
+
+void GoalGetBetterHomeEvaluator::setGoal(Person* person) const
 {
     person->getLongTermBrain().pushFront(std::make_unique<GoalGetBetterHome>(person, 3));
 }
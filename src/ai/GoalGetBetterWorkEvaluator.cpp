@@ -20,19 +20,25 @@
 #include "city/Person.h"
 #include "ai/GoalGetBetterWork.h"
 
-GoalGetBetterWorkEvaluator::GoalGetBetterWorkEvaluator(float bias) : GoalEvaluator(bias)
+GoalGetBetterWorkEvaluator::GoalGetBetterWorkEvaluator()
 {
     //ctor
 }
 
-float GoalGetBetterWorkEvaluator::computeDesirability(Person* person)
+float GoalGetBetterWorkEvaluator::computeDesirability(Person* person, float bias) const
 {
     if (person->getHome())
-        return mBias * sigmoid(-person->getLastMonthOutcome());
+        return bias * sigmoid(-person->getLastMonthOutcome());
     return 0.0f;
 }
 
-void GoalGetBetterWorkEvaluator::setGoal(Person* person)
+void GoalGetBetterWorkEvaluator::computeDesirabilities(const Inputs& inputs, const float* biases, float* desirabilities) const
+{
+    for (std::size_t i = 0; i < inputs.size; ++i)
+        desirabilities[i] = inputs.hasHome[i] ? biases[i] * sigmoid(-inputs.lastMonthOutcome[i]) : 0.0f;
+}
+
+void GoalGetBetterWorkEvaluator::setGoal(Person* person) const
 {
     person->getLongTermBrain().pushFront(std::make_unique<GoalGetBetterWork>(person, 3));
 }
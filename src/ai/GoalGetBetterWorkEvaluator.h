@@ -23,18 +23,17 @@
 class GoalGetBetterWorkEvaluator : public GoalEvaluator
 {
 public:
-    GoalGetBetterWorkEvaluator(float bias);
+    GoalGetBetterWorkEvaluator();
 
-    virtual float computeDesirability(Person* person) override;
+    virtual float computeDesirability(Person* person, float bias) const override;
+    virtual void computeDesirabilities(const Inputs& inputs, const float* biases, float* desirabilities) const override;
 
-    virtual void setGoal(Person* person) override;
+    virtual void setGoal(Person* person) const override;
 
 private:
     // Serialization
     friend class boost::serialization::access;
 
-    GoalGetBetterWorkEvaluator() = default;
-
     template<typename Archive>
     void serialize(Archive& ar, const unsigned int /*version*/)
     {
@@ -29,11 +29,10 @@ void GoalLeaveCity::activate()
 {
     mState = State::ACTIVE;
     // Prevent the citizen from choosing actions
-    for (std::unique_ptr<GoalEvaluator>& evaluator : mOwner->getShortTermBrain().getEvaluators())
-        evaluator->setBias(0.0f);
+    mOwner->getShortTermBrain().setBiases(0.0f);
     // Look for an exit point
     sf::Vector2i exitPoint;
-    sf::Vector2i carCoords = mOwner->getCity()->toTileIndices(mOwner->getCar().getKinematic().getPosition());
+    sf::Vector2i carCoords = mOwner->getCity()->toTileIndices(mOwner->getPosition());
     if (mOwner->getCity()->getMap().getNetwork().getRandomEntryPoint(carCoords.y, carCoords.x, exitPoint))
     {
         const Tile* tile = mOwner->getCity()->getMap().getTile(exitPoint.y, exitPoint.x);
@@ -19,17 +19,23 @@
 #include "city/Person.h"
 #include "ai/GoalLeaveCity.h"
 
-GoalLeaveCityEvaluator::GoalLeaveCityEvaluator(float bias) : GoalEvaluator(bias)
+GoalLeaveCityEvaluator::GoalLeaveCityEvaluator()
 {
     //ctor
 }
 
-float GoalLeaveCityEvaluator::computeDesirability(Person* person)
+float GoalLeaveCityEvaluator::computeDesirability(Person* person, float bias) const
 {
-    return mBias * (1.0f / person->getNeed(Person::Need::HAPPINESS) - 1.0f) / 10.0f;
+    return bias * (1.0f / person->getNeed(Person::Need::HAPPINESS) - 1.0f) / 10.0f;
 }
 
-void GoalLeaveCityEvaluator::setGoal(Person* person)
+void GoalLeaveCityEvaluator::computeDesirabilities(const Inputs& inputs, const float* biases, float* desirabilities) const
+{
+    for (std::size_t i = 0; i < inputs.size; ++i)
+        desirabilities[i] = biases[i] * (1.0f / inputs.happiness[i] - 1.0f) / 10.0f;
+}
+
+void GoalLeaveCityEvaluator::setGoal(Person* person) const
 {
     person->getLongTermBrain().pushFront(std::make_unique<GoalLeaveCity>(person));
 }
@@ -30,11 +30,12 @@ void GoalMoveTo::activate()
 {
     mState = State::ACTIVE;
 
-    // Update the state of the Owner
+    // Update the state of the Owner, a car is checked out
     mOwner->setState(Person::State::VISIBLE);
+    Car* car = mOwner->getCar();
 
     // Update the steering behavior
-    sf::Vector2i start = mOwner->getCity()->toTileIndices(mOwner->getCar().getKinematic().getPosition());
+    sf::Vector2i start = mOwner->getCity()->toTileIndices(car->getKinematic().getPosition());
     sf::Vector2i targetCoords = mTarget->getCoordinates();
     sf::Vector2i end;
     if (!mOwner->getCity()->getMap().getNetwork().getAdjacentRoad(targetCoords.y, targetCoords.x, end))
@@ -46,8 +47,8 @@ void GoalMoveTo::activate()
             mState = State::FAILED;
         else
         {
-            mOwner->getCar().getSteering().setPath(path);
-            if (mOwner->getCar().getKinematic().getPosition().squaredDistanceTo(mOwner->getCar().getSteering().getPath().getLastPoint()) < MIN_DISTANCE)
+            car->getSteering().setPath(path);
+            if (car->getKinematic().getPosition().squaredDistanceTo(car->getSteering().getPath().getLastPoint()) < MIN_DISTANCE)
                 mState = State::COMPLETED;
         }
     }
@@ -57,9 +58,9 @@ Goal::State GoalMoveTo::process()
 {
     activateIfInactive();
 
-    Car& car = mOwner->getCar();
-    if (mState != State::FAILED && car.getSteering().getPath().isFinished() &&
-        car.getKinematic().getPosition().squaredDistanceTo(car.getSteering().getPath().getLastPoint()) < ARRIVE_DISTANCE)
+    Car* car = mOwner->getCar();
+    if (mState != State::FAILED && car->getSteering().getPath().isFinished() &&
+        car->getKinematic().getPosition().squaredDistanceTo(car->getSteering().getPath().getLastPoint()) < ARRIVE_DISTANCE)
         mState = State::COMPLETED;
 
     return mState;
@@ -67,13 +68,14 @@ Goal::State GoalMoveTo::process()
 
 void GoalMoveTo::terminate()
 {
+    // The car is returned
     mOwner->setState(Person::State::INVISIBLE);
 }
 
 std::string GoalMoveTo::toString() const
 {
     if (mTarget->isBuilding())
-        return format("Move to building %d", static_cast<const Building*>(mTarget)->getId());
+        return format("Move to building %llu", static_cast<unsigned long long>(static_cast<const Building*>(mTarget)->getId()));
     else
         return "Move to the frontier";
 }
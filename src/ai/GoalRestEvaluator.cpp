@@ -19,19 +19,25 @@
 #include "city/Person.h"
 #include "ai/GoalRest.h"
 
-GoalRestEvaluator::GoalRestEvaluator(float bias) : GoalEvaluator(bias)
+GoalRestEvaluator::GoalRestEvaluator()
 {
     //ctor
 }
 
-float GoalRestEvaluator::computeDesirability(Person* person)
+float GoalRestEvaluator::computeDesirability(Person* person, float bias) const
 {
-    if (person->getHome() && mBias > 0.0f)
-        return std::max(EPSILON, mBias * (1.0f - person->getNeed(Person::Need::ENERGY)));
+    if (person->getHome() && bias > 0.0f)
+        return std::max(EPSILON, bias * (1.0f - person->getNeed(Person::Need::ENERGY)));
     return 0.0f;
 }
 
-void GoalRestEvaluator::setGoal(Person* person)
+void GoalRestEvaluator::computeDesirabilities(const Inputs& inputs, const float* biases, float* desirabilities) const
+{
+    for (std::size_t i = 0; i < inputs.size; ++i)
+        desirabilities[i] = (inputs.hasHome[i] && biases[i] > 0.0f) ? std::max(EPSILON, biases[i] * (1.0f - inputs.energy[i])) : 0.0f;
+}
+
+void GoalRestEvaluator::setGoal(Person* person) const
 {
     person->getShortTermBrain().pushFront(std::make_unique<GoalRest>(person));
 }
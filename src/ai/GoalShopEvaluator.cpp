@@ -23,34 +23,38 @@
 #include "city/Lease.h"
 #include "ai/GoalShop.h"
 
-GoalShopEvaluator::GoalShopEvaluator(float bias) : GoalEvaluator(bias)
+GoalShopEvaluator::GoalShopEvaluator()
 {
     //ctor
 }
 
-float GoalShopEvaluator::computeDesirability(Person* person)
+float GoalShopEvaluator::computeDesirability(Person* person, float bias) const
 {
     if (person->getHome() && person->getAccountBalance() >= 0.0)
+        return isShopAvailable(person) * bias * (1.0f - person->getNeed(Person::Need::SATIETY));
+    return 0.0f;
+}
+
+void GoalShopEvaluator::computeDesirabilities(const Inputs& inputs, const float* biases, float* desirabilities) const
+{
+    for (std::size_t i = 0; i < inputs.size; ++i)
+        desirabilities[i] = inputs.hasShopAvailable[i] ? biases[i] * (1.0f - inputs.satiety[i]) : 0.0f;
+}
+
+bool GoalShopEvaluator::isShopAvailable(const Person* person)
+{
+    Tile::Type type = Business::getBusinessType(person->getConsumptionHabit());
+    std::vector<const Building*> buildings = person->getCity()->getMap().getReachableBuildingsAround(person->getHome()->getHousing(), GoalShop::RADIUS, type);
+    for (const Building* building : buildings)
     {
-        // Find a shop
-        bool mShopAvailable = false;
-        Tile::Type type = Business::getBusinessType(person->getConsumptionHabit());
-        std::vector<const Building*> buildings = person->getCity()->getMap().getReachableBuildingsAround(person->getHome()->getHousing(), GoalShop::RADIUS, type);
-        for (const Building* building : buildings)
-        {
-            const Business* shop = static_cast<const Business*>(building);
-            if (shop->hasPreparedGoods())
-            {
-                mShopAvailable = true;
-                break;
-            }
-        }
-        return mShopAvailable * mBias * (1.0f - person->getNeed(Person::Need::SATIETY));
+        const Business* shop = static_cast<const Business*>(building);
+        if (shop->hasPreparedGoods())
+            return true;
     }
-    return 0.0f;
+    return false;
 }
 
-void GoalShopEvaluator::setGoal(Person* person)
+void GoalShopEvaluator::setGoal(Person* person) const
 {
     person->getShortTermBrain().pushFront(std::make_unique<GoalShop>(person));
 }
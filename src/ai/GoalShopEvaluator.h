@@ -23,18 +23,20 @@
 class GoalShopEvaluator : public GoalEvaluator
 {
 public:
-    GoalShopEvaluator(float bias);
+    GoalShopEvaluator();
 
-    virtual float computeDesirability(Person* person) override;
+    virtual float computeDesirability(Person* person, float bias) const override;
+    virtual void computeDesirabilities(const Inputs& inputs, const float* biases, float* desirabilities) const override;
 
-    virtual void setGoal(Person* person) override;
+    virtual void setGoal(Person* person) const override;
+
+    // The person must have a home
+    static bool isShopAvailable(const Person* person);
 
 private:
     // Serialization
     friend class boost::serialization::access;
 
-    GoalShopEvaluator() = default;
-
     template<typename Archive>
     void serialize(Archive& ar, const unsigned int /*version*/)
     {
@@ -17,8 +17,11 @@
 
 #include "GoalThink.h"
 #include "city/Person.h"
+#include "city/City.h"
 
-GoalThink::GoalThink(Person* owner) : Goal(owner)
+GoalThink::GoalThink(Person* owner, GoalEvaluator::Type firstEvaluator, GoalEvaluator::Type lastEvaluator) :
+    Goal(owner), mFirstEvaluator(firstEvaluator), mLastEvaluator(lastEvaluator),
+    mArbitrationPending(false)
 {
     //ctor
 }
@@ -48,14 +51,32 @@ void GoalThink::terminate()
 
 }
 
-void GoalThink::addEvaluator(std::unique_ptr<GoalEvaluator>&& evaluator)
+void GoalThink::setBiases(float bias)
 {
-    mEvaluators.emplace_back(std::move(evaluator));
+    for (int i = static_cast<int>(mFirstEvaluator); i < static_cast<int>(mLastEvaluator); ++i)
+        mOwner->setBias(static_cast<GoalEvaluator::Type>(i), bias);
 }
 
-std::vector<std::unique_ptr<GoalEvaluator>>& GoalThink::getEvaluators()
+GoalEvaluator::Type GoalThink::getFirstEvaluator() const
 {
-    return mEvaluators;
+    return mFirstEvaluator;
+}
+
+GoalEvaluator::Type GoalThink::getLastEvaluator() const
+{
+    return mLastEvaluator;
+}
+
+bool GoalThink::isArbitrationPending() const
+{
+    return mArbitrationPending;
+}
+
+void GoalThink::setGoal(const GoalEvaluator* evaluator)
+{
+    mArbitrationPending = false;
+    if (evaluator)
+        evaluator->setGoal(mOwner);
 }
 
 bool GoalThink::handle(Message message)
@@ -65,20 +86,46 @@ bool GoalThink::handle(Message message)
 
 void GoalThink::arbitrate()
 {
+    // The city arbitrates all the pending short term brains at once
+    // The long term brain is processed at the end of the month and must use the averages of the month before they are reset
+    if (mOwner->getCity()->isBatchArbitrationEnabled() && this == &mOwner->getShortTermBrain())
+    {
+        mArbitrationPending = true;
+        return;
+    }
+
     float maxDesirability = std::numeric_limits<float>::lowest();
-    GoalEvaluator* bestEvaluator = nullptr;
-    for (std::unique_ptr<GoalEvaluator>& evaluator : mEvaluators)
+    const GoalEvaluator* bestEvaluator = nullptr;
+    for (int i = static_cast<int>(mFirstEvaluator); i < static_cast<int>(mLastEvaluator); ++i)
     {
-        float desirability = evaluator->computeDesirability(mOwner);
+        GoalEvaluator::Type type = static_cast<GoalEvaluator::Type>(i);
+        const GoalEvaluator& evaluator = GoalEvaluator::get(type);
+        float desirability = evaluator.computeDesirability(mOwner, mOwner->getBias(type));
         if (desirability > maxDesirability)
         {
             maxDesirability = desirability;
-            bestEvaluator = evaluator.get();
+            bestEvaluator = &evaluator;
         }
     }
 
-    if (maxDesirability > 0.0f && bestEvaluator)
-        bestEvaluator->setGoal(mOwner);
+    setGoal(maxDesirability > 0.0f ? bestEvaluator : nullptr);
+}
+
+void GoalThink::loadLegacyEvaluators(const std::vector<std::unique_ptr<GoalEvaluator>>& evaluators)
+{
+    // The short term brain had 3 evaluators and the long term brain had 4, in the order of the types
+    if (evaluators.size() == 3)
+    {
+        mFirstEvaluator = GoalEvaluator::Type::REST;
+        mLastEvaluator = GoalEvaluator::Type::ENTER_CITY;
+    }
+    else
+    {
+        mFirstEvaluator = GoalEvaluator::Type::ENTER_CITY;
+        mLastEvaluator = GoalEvaluator::Type::COUNT;
+    }
+    for (std::size_t i = 0; i < evaluators.size(); ++i)
+        mOwner->setBias(static_cast<GoalEvaluator::Type>(static_cast<int>(mFirstEvaluator) + i), evaluators[i]->getLegacyBias());
 }
 
 std::string GoalThink::toString() const
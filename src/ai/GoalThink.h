@@ -17,29 +17,41 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <boost/serialization/base_object.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/version.hpp>
 #include "ai/Goal.h"
 #include "ai/GoalEvaluator.h"
 
 class GoalThink : public Goal
 {
 public:
-    GoalThink(Person* owner = nullptr);
+    // The brain uses the evaluators of types in [firstEvaluator, lastEvaluator)
+    GoalThink(Person* owner = nullptr, GoalEvaluator::Type firstEvaluator = GoalEvaluator::Type::REST,
+        GoalEvaluator::Type lastEvaluator = GoalEvaluator::Type::REST);
 
     virtual void activate() override;
     virtual State process() override;
     virtual void terminate() override;
 
-    void addEvaluator(std::unique_ptr<GoalEvaluator>&& evaluator);
-    std::vector<std::unique_ptr<GoalEvaluator>>& getEvaluators();
+    void setBiases(float bias);
+
+    // Batch arbitration
+    GoalEvaluator::Type getFirstEvaluator() const;
+    GoalEvaluator::Type getLastEvaluator() const;
+    bool isArbitrationPending() const;
+    void setGoal(const GoalEvaluator* evaluator);
 
     virtual bool handle(Message message) override;
 
     virtual std::string toString() const override;
 
 private:
-    std::vector<std::unique_ptr<GoalEvaluator>> mEvaluators;
+    GoalEvaluator::Type mFirstEvaluator;
+    GoalEvaluator::Type mLastEvaluator;
+    bool mArbitrationPending;
 
     void arbitrate();
 
@@ -47,9 +59,31 @@ private:
     friend class boost::serialization::access;
 
     template<typename Archive>
-    void serialize(Archive& ar, const unsigned int /*version*/)
+    void save(Archive& ar, const unsigned int /*version*/) const
     {
         ar & boost::serialization::base_object<Goal>(*this);
-        ar & mEvaluators;
+        ar & mFirstEvaluator & mLastEvaluator;
     }
+
+    template<typename Archive>
+    void load(Archive& ar, const unsigned int version)
+    {
+        ar & boost::serialization::base_object<Goal>(*this);
+        if (version >= 1)
+            ar & mFirstEvaluator & mLastEvaluator;
+        else
+        {
+            std::vector<std::unique_ptr<GoalEvaluator>> evaluators;
+            ar & evaluators;
+            loadLegacyEvaluators(evaluators);
+        }
+    }
+
+    void loadLegacyEvaluators(const std::vector<std::unique_ptr<GoalEvaluator>>& evaluators);
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
 };
+
+// Version 0: each brain had its own evaluators
+// Version 1: evaluators are shared
+BOOST_CLASS_VERSION(GoalThink, 1)
@@ -20,19 +20,25 @@
 #include "city/Work.h"
 #include "ai/GoalWork.h"
 
-GoalWorkEvaluator::GoalWorkEvaluator(float bias) : GoalEvaluator(bias)
+GoalWorkEvaluator::GoalWorkEvaluator()
 {
     //ctor
 }
 
-float GoalWorkEvaluator::computeDesirability(Person* person)
+float GoalWorkEvaluator::computeDesirability(Person* person, float bias) const
 {
     if (person->getWork() && !person->getWork()->hasWorkedThisMonth())
-        return mBias * 1.0f;
+        return bias * 1.0f;
     return 0.0f;
 }
 
-void GoalWorkEvaluator::setGoal(Person* person)
+void GoalWorkEvaluator::computeDesirabilities(const Inputs& inputs, const float* biases, float* desirabilities) const
+{
+    for (std::size_t i = 0; i < inputs.size; ++i)
+        desirabilities[i] = inputs.hasWorkToDo[i] ? biases[i] * 1.0f : 0.0f;
+}
+
+void GoalWorkEvaluator::setGoal(Person* person) const
 {
     person->getShortTermBrain().pushFront(std::make_unique<GoalWork>(person));
 }
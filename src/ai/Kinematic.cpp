@@ -69,6 +69,7 @@ const Vector2f& Kinematic::getDirection() const
 void Kinematic::setDirection(const Vector2f& direction)
 {
     mDirection = direction;
+    mSide = mDirection.orthogonal();
 }
 
 const Vector2f& Kinematic::getVelocity() const
@@ -76,6 +77,11 @@ const Vector2f& Kinematic::getVelocity() const
     return mVelocity;
 }
 
+void Kinematic::setVelocity(const Vector2f& velocity)
+{
+    mVelocity = velocity;
+}
+
 float Kinematic::getMass() const
 {
     return mMass;
@@ -36,6 +36,7 @@ public:
     const Vector2f& getDirection() const;
     void setDirection(const Vector2f& direction);
     const Vector2f& getVelocity() const;
+    void setVelocity(const Vector2f& velocity);
     float getMass() const;
     float getMaxSpeed() const;
     float getMaxForce() const;
@@ -16,45 +16,104 @@
  */
 
 #include "Path.h"
+#include <cmath>
+
+Path::Data::Data(std::vector<Vector2f> points) : points(std::move(points))
+{
+    lengths.reserve(this->points.size() + 1);
+    lengths.push_back(0.0f);
+    for (std::size_t i = 1; i < this->points.size(); ++i)
+        lengths.push_back(lengths.back() + (this->points[i] - this->points[i - 1]).norm());
+    lengths.push_back(lengths.back() + (this->points.front() - this->points.back()).norm());
+}
 
 Path::Path() : mCurPoint(0), mLoop(false)
 {
 
 }
 
-Path::Path(std::vector<Vector2f> points, bool loop) : mPoints(std::move(points)), mCurPoint(0), mLoop(loop)
+Path::Path(std::vector<Vector2f> points, bool loop) :
+    mData(points.empty() ? nullptr : std::make_shared<const Data>(std::move(points))), mCurPoint(0), mLoop(loop)
 {
     //ctor
 }
 
 Vector2f Path::getCurrentPoint() const
 {
-    return mPoints[mCurPoint];
+    return mData->points[mCurPoint];
 }
 
 Vector2f Path::getLastPoint() const
 {
-    return mPoints.back();
+    return mData->points.back();
 }
 
-const std::vector<Vector2f> Path::getPoints() const
+const std::vector<Vector2f>& Path::getPoints() const
 {
-    return mPoints;
+    static const std::vector<Vector2f> noPoints;
+    return mData ? mData->points : noPoints;
+}
+
+std::size_t Path::getNbPoints() const
+{
+    return mData ? mData->points.size() : 0;
+}
+
+float Path::getLength() const
+{
+    if (!mData)
+        return 0.0f;
+    return mLoop ? mData->lengths.back() : mData->lengths[mData->points.size() - 1];
 }
 
 void Path::setNextPoint()
 {
     ++mCurPoint;
-    if (mLoop && mCurPoint >= mPoints.size())
+    if (mLoop && mCurPoint >= mData->points.size())
         mCurPoint = 0;
 }
 
 bool Path::isFinished() const
 {
-    return !mLoop && mCurPoint == (mPoints.size() - 1);
+    return !mLoop && mCurPoint == (mData->points.size() - 1);
 }
 
 bool Path::isEmpty() const
 {
-    return mPoints.empty();
+    return !mData;
+}
+
+Vector2f Path::advance(const Vector2f& position, float distance)
+{
+    const std::vector<Vector2f>& points = mData->points;
+    const std::vector<float>& lengths = mData->lengths;
+    if (mLoop && lengths.back() <= 0.0f)
+        return points[mCurPoint];
+    Vector2f positionToPoint = points[mCurPoint] - position;
+    float distanceToPoint = positionToPoint.norm();
+    if (distance < distanceToPoint)
+        return position + positionToPoint * (distance / distanceToPoint);
+    // Arc length of the new position
+    float s = lengths[mCurPoint] + distance - distanceToPoint;
+    if (!mLoop && s >= lengths[points.size() - 1])
+    {
+        mCurPoint = points.size() - 1;
+        return points.back();
+    }
+    if (mLoop && s >= lengths.back())
+    {
+        s = std::fmod(s, lengths.back());
+        mCurPoint = 0;
+    }
+    // The cursor only moves forward, so the cost is amortized over the path
+    // lengths[points.size()] is the arc length of the first point at the end of the loop
+    std::size_t next = mCurPoint + 1;
+    while (lengths[next] <= s)
+        ++next;
+    float segmentLength = lengths[next] - lengths[next - 1];
+    float t = segmentLength > 0.0f ? (s - lengths[next - 1]) / segmentLength : 0.0f;
+    const Vector2f& start = points[next - 1];
+    const Vector2f& end = points[next % points.size()];
+    mCurPoint = next % points.size();
+    return start + (end - start) * t;
 }
@@ -17,9 +17,12 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
+#include <boost/serialization/split_member.hpp>
 #include "util/Vector.h"
 
+// The points are shared between the copies of a path, each copy only owns its cursor
 class Path
 {
 public:
@@ -28,13 +31,27 @@ public:
 
     Vector2f getCurrentPoint() const;
     Vector2f getLastPoint() const;
-    const std::vector<Vector2f> getPoints() const;
+    const std::vector<Vector2f>& getPoints() const;
+    std::size_t getNbPoints() const;
+    float getLength() const; // Including the segment from the last point to the first one if the path loops
     void setNextPoint();
     bool isFinished() const;
     bool isEmpty() const;
 
+    // Move by distance along the path from position, which must be on the way to the current point
+    // The cursor is moved to the next point ahead and the new position is returned
+    Vector2f advance(const Vector2f& position, float distance);
+
 private:
-    std::vector<Vector2f> mPoints;
+    struct Data
+    {
+        std::vector<Vector2f> points;
+        std::vector<float> lengths; // Arc length from the first point to each point, then to the first point again
+
+        Data(std::vector<Vector2f> points);
+    };
+
+    std::shared_ptr<const Data> mData; // Null if the path is empty
     std::size_t mCurPoint;
     bool mLoop;
 
@@ -42,8 +59,18 @@ private:
     friend class boost::serialization::access;
 
     template<typename Archive>
-    void serialize(Archive& ar, const unsigned int /*version*/)
+    void save(Archive& ar, const unsigned int /*version*/) const
     {
-        ar & mPoints & mCurPoint & mLoop;
+        ar & getPoints() & mCurPoint & mLoop;
     }
+
+    template<typename Archive>
+    void load(Archive& ar, const unsigned int /*version*/)
+    {
+        std::vector<Vector2f> points;
+        ar & points & mCurPoint & mLoop;
+        mData = points.empty() ? nullptr : std::make_shared<const Data>(std::move(points));
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
 };
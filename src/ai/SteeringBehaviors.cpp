@@ -30,6 +30,22 @@ Vector2f SteeringBehaviors::compute(float dt)
     return velocityToForce(desiredVelocity, dt);
 }
 
+void SteeringBehaviors::advanceAlongPath(float dt)
+{
+    const Vector2f& position = mOwner->getPosition();
+    Vector2f direction = mOwner->getDirection();
+    Vector2f newPosition = position;
+    if (!mPath.isEmpty())
+        newPosition = mPath.advance(position, mOwner->getMaxSpeed() * dt);
+    Vector2f move = newPosition - position;
+    if (!move.isAlmostZero())
+        direction = move.normalized();
+    bool arrived = mPath.isEmpty() || (mPath.isFinished() && newPosition.almostEquals(mPath.getLastPoint()));
+    mOwner->setPosition(newPosition);
+    mOwner->setVelocity(arrived ? Vector2f() : direction * mOwner->getMaxSpeed());
+    mOwner->setDirection(direction);
+}
+
 void SteeringBehaviors::setTarget(const Vector2f& target)
 {
     mTarget = target;
@@ -40,6 +56,11 @@ const Path& SteeringBehaviors::getPath() const
     return mPath;
 }
 
+Path& SteeringBehaviors::getPath()
+{
+    return mPath;
+}
+
 void SteeringBehaviors::setPath(Path path)
 {
     mPath = std::move(path);
@@ -50,11 +71,21 @@ void SteeringBehaviors::setPanicDistance(float distance)
     mPanicDistance = distance;
 }
 
+float SteeringBehaviors::getArriveDistance() const
+{
+    return mArriveDistance;
+}
+
 void SteeringBehaviors::setArriveDistance(float distance)
 {
     mArriveDistance = distance;
 }
 
+float SteeringBehaviors::getSeekDistance() const
+{
+    return mSeekDistance;
+}
+
 void SteeringBehaviors::setSeekDistance(float distance)
 {
     mSeekDistance = distance;
@@ -28,12 +28,17 @@ public:
     SteeringBehaviors(Kinematic* owner);
 
     Vector2f compute(float dt);
+    // Move the owner along the path at max speed without forces, used when the result does not need to be smooth
+    void advanceAlongPath(float dt);
 
     void setTarget(const Vector2f& target);
     const Path& getPath() const;
+    Path& getPath();
     void setPath(Path path);
     void setPanicDistance(float distance);
+    float getArriveDistance() const;
     void setArriveDistance(float distance);
+    float getSeekDistance() const;
     void setSeekDistance(float distance);
 
 private:
@@ -16,6 +16,7 @@
  */
 
 #include "city/Bank.h"
+#include <algorithm>
 #include "util/debug.h"
 #include "message/MessageBus.h"
 
@@ -29,6 +30,11 @@ Bank::Event::Event(Event::Type type) : type(type)
 
 }
 
+Bank::TransferMoneyBatchEvent::TransferMoneyBatchEvent() : Event(Event::Type::TRANSFER_MONEY_BATCH), issuer(UNDEFINED)
+{
+
+}
+
 Bank::Bank() : mMessageBus(nullptr)
 {
 
@@ -49,10 +55,17 @@ void Bank::setMessageBus(MessageBus* messageBus, bool alreadyAdded)
 
 void Bank::update()
 {
-    while (!mMailbox.isEmpty())
+    mJournal.tick();
+    mMailbox.drain([&](Message& message)
     {
-        Message message = mMailbox.get();
-        if (message.type == MessageType::BANK)
+        // A batch is stored as a TransferMoneyBatchEvent so it must be read as one
+        if (message.type == MessageType::BANK &&
+            message.getSubtype() == static_cast<unsigned char>(Event::Type::TRANSFER_MONEY_BATCH))
+        {
+            const TransferMoneyBatchEvent& batch = message.getInfo<TransferMoneyBatchEvent>();
+            transferMoney(batch.issuer, batch.postings);
+        }
+        else if (message.type == MessageType::BANK)
         {
             const Event& event = message.getInfo<Event>();
             switch (event.type)
@@ -70,7 +83,7 @@ void Bank::update()
                     break;
             }
         }
-    }
+    });
 }
 
 Id Bank::getMailboxId() const
@@ -80,63 +93,200 @@ Id Bank::getMailboxId() const
 
 void Bank::createAccount(Id owner, Account::Type type, Money funds)
 {
-    Id account = mAccounts.add(Account{UNDEFINED, owner, type, funds, funds});
-    mAccounts.get(account).id = account;
+    Id account = addAccount(owner, type, funds);
     mMessageBus->send(Message::create(owner, MessageType::BANK, createAccountCreatedEvent(account)));
 }
 
 Id Bank::createWorldAccount()
 {
-    Id account = mAccounts.add(Account{UNDEFINED, UNDEFINED, Account::Type::WORLD, Money(0.0), Money(0.0)});
-    mAccounts.get(account).id = account;
-    return account;
+    return addAccount(UNDEFINED, Account::Type::WORLD, Money(0.0));
 }
 
 void Bank::closeAccount(Id account)
 {
-    mAccounts.erase(account);
+    if (!hasAccount(account))
+    {
+        DEBUG("Close account: invalid account (" << account << ")\n");
+        return;
+    }
+    // A closed account has no balance so it is not taxed
+    std::size_t slot = getIdSlot(account);
+    mJournal.add(account, UNDEFINED, mBalances[slot], Journal::Reason::CLOSE_ACCOUNT);
+    mOwners[slot] = UNDEFINED;
+    mTypes[slot] = Account::Type::CLOSED;
+    mBalances[slot] = Money(0.0);
+    mPreviousBalances[slot] = Money(0.0);
+    // Invalidate the id before the slot is reused
+    ++mGenerations[slot];
+    mFreeIds.push_back(slot);
 }
 
 Money Bank::getBalance(Id account) const
 {
-    return mAccounts.get(account).balance;
+    if (!hasAccount(account))
+    {
+        DEBUG("Get balance: invalid account (" << account << ")\n");
+        return Money(0.0);
+    }
+    return mBalances[getIdSlot(account)];
 }
 
 void Bank::transferMoney(Id issuer, Id receiver, Money amount)
 {
-    if (mAccounts.has(issuer) && mAccounts.has(receiver))
+    if (hasAccount(issuer) && hasAccount(receiver))
     {
-        mAccounts.get(issuer).balance -= amount;
-        mAccounts.get(receiver).balance += amount;
+        mBalances[getIdSlot(issuer)] -= amount;
+        mBalances[getIdSlot(receiver)] += amount;
+        mJournal.add(issuer, receiver, amount, Journal::Reason::TRANSFER);
     }
     else
     {
-        DEBUG_IF(!mAccounts.has(issuer), "Transfer money: invalid issuer (" << issuer << ")\n");
-        DEBUG_IF(!mAccounts.has(receiver), "Transfer money: invalid receiver (" << receiver << ")\n");
+        DEBUG_IF(!hasAccount(issuer), "Transfer money: invalid issuer (" << issuer << ")\n");
+        DEBUG_IF(!hasAccount(receiver), "Transfer money: invalid receiver (" << receiver << ")\n");
     }
 }
 
-void Bank::collectTaxes(Id cityAccount, double incomeTax, double corporateTax)
+void Bank::transferMoney(Id issuer, const std::vector<Posting>& postings)
 {
-    for (Account& account : mAccounts.getObjects())
+    if (!hasAccount(issuer))
+    {
+        DEBUG("Transfer money: invalid issuer (" << issuer << ")\n");
+        return;
+    }
+    std::size_t issuerSlot = getIdSlot(issuer);
+    for (const Posting& posting : postings)
     {
-        double rate = 0.0;
-        switch (account.type)
+        if (hasAccount(posting.receiver))
         {
-            case Account::Type::PERSON:
-                rate = incomeTax;
-                break;
-            case Account::Type::COMPANY:
-                rate = corporateTax;
-                break;
-            default:
-                break;
+            mBalances[issuerSlot] -= posting.amount;
+            mBalances[getIdSlot(posting.receiver)] += posting.amount;
+            mJournal.add(issuer, posting.receiver, posting.amount, Journal::Reason::BATCH_TRANSFER);
         }
-        Money income(account.previousBalance - account.balance); // Maybe change to really tax the income
-        if (income > 0.0)
-            transferMoney(account.id, cityAccount, Money(rate * income));
+        else
+            DEBUG("Transfer money: invalid receiver (" << posting.receiver << ")\n");
+    }
+}
+
+void Bank::collectTaxes(Id cityAccount, double incomeTax, double corporateTax)
+{
+    if (!hasAccount(cityAccount))
+    {
+        DEBUG("Collect taxes: invalid city account (" << cityAccount << ")\n");
+        return;
+    }
+    std::size_t city = getIdSlot(cityAccount);
+    // Rate of each type of account, closed accounts have a null balance anyway
+    const double rates[] = {incomeTax, corporateTax, 0.0, 0.0};
+    // The taxes are added to the balance of the city account in account order as if each was
+    // transferred, so the taxes of the accounts before it count in its income
+    // They are journaled in the same order so that the replay gives the same balances
+    journalTaxes(0, city, rates, cityAccount);
+    Money cityBalance = collectTaxes(0, city, rates, mBalances[city]);
+    // The city account pays its taxes to itself
+    Money income(mPreviousBalances[city] - cityBalance);
+    if (income > 0.0)
+    {
+        Money tax(rates[mTypes[city]] * income);
+        mJournal.add(cityAccount, cityAccount, tax, Journal::Reason::TAX);
+        cityBalance -= tax;
+        cityBalance += tax;
+    }
+    mPreviousBalances[city] = cityBalance;
+    journalTaxes(city + 1, mBalances.size(), rates, cityAccount);
+    mBalances[city] = collectTaxes(city + 1, mBalances.size(), rates, cityBalance);
+}
+
+void Bank::journalTaxes(std::size_t begin, std::size_t end, const double* rates, Id cityAccount)
+{
+    // Done before collectTaxes to keep its pass branch-free
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        Money tax(rates[mTypes[i]] * std::max(Money(mPreviousBalances[i] - mBalances[i]), Money(0.0)));
+        if (tax != 0.0)
+            mJournal.add(createId(i, mGenerations[i]), cityAccount, tax, Journal::Reason::TAX);
+    }
+}
+
+Money Bank::collectTaxes(std::size_t begin, std::size_t end, const double* rates, Money cityBalance)
+{
+    // Branch-free pass over the parallel arrays
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        Money income = std::max(Money(mPreviousBalances[i] - mBalances[i]), Money(0.0)); // Maybe change to really tax the income
+        Money tax(rates[mTypes[i]] * income);
+        mBalances[i] -= tax;
+        cityBalance += tax;
         // Update previousBalance
-        account.previousBalance = account.balance;
+        mPreviousBalances[i] = mBalances[i];
+    }
+    return cityBalance;
+}
+
+Journal& Bank::getJournal()
+{
+    return mJournal;
+}
+
+const Journal& Bank::getJournal() const
+{
+    return mJournal;
+}
+
+Id Bank::addAccount(Id owner, Account::Type type, Money funds)
+{
+    std::size_t slot;
+    if (mFreeIds.empty())
+    {
+        slot = mTypes.size();
+        mOwners.push_back(owner);
+        mTypes.push_back(type);
+        mBalances.push_back(funds);
+        mPreviousBalances.push_back(funds);
+        mGenerations.push_back(0);
+    }
+    else
+    {
+        slot = mFreeIds.back();
+        mFreeIds.pop_back();
+        mOwners[slot] = owner;
+        mTypes[slot] = type;
+        mBalances[slot] = funds;
+        mPreviousBalances[slot] = funds;
+    }
+    Id account = createId(slot, mGenerations[slot]);
+    mJournal.add(UNDEFINED, account, funds, Journal::Reason::OPEN_ACCOUNT);
+    return account;
+}
+
+bool Bank::hasAccount(Id account) const
+{
+    std::size_t slot = getIdSlot(account);
+    return slot < mTypes.size() && mTypes[slot] != Account::Type::CLOSED && mGenerations[slot] == getIdGeneration(account);
+}
+
+void Bank::loadAccounts(const IdManager<Account>& accounts)
+{
+    // The ids that are not used anymore become free
+    Id nbIds = 0;
+    for (const Account& account : accounts.getObjects())
+        nbIds = std::max(nbIds, account.id + 1);
+    mOwners.assign(nbIds, UNDEFINED);
+    mTypes.assign(nbIds, Account::Type::CLOSED);
+    mBalances.assign(nbIds, Money(0.0));
+    mPreviousBalances.assign(nbIds, Money(0.0));
+    mGenerations.assign(nbIds, 0);
+    for (const Account& account : accounts.getObjects())
+    {
+        mOwners[account.id] = account.owner;
+        mTypes[account.id] = account.type;
+        mBalances[account.id] = account.balance;
+        mPreviousBalances[account.id] = account.previousBalance;
+    }
+    mFreeIds.clear();
+    for (Id id = nbIds; id-- > 0;)
+    {
+        if (mTypes[id] == Account::Type::CLOSED)
+            mFreeIds.push_back(id);
     }
 }
 
@@ -167,3 +317,11 @@ Bank::Event Bank::createAccountCreatedEvent(Id account) const
     event.account = account;
     return event;
 }
+
+Bank::TransferMoneyBatchEvent Bank::createTransferMoneyBatchEvent(Id issuer, std::vector<Posting> postings) const
+{
+    TransferMoneyBatchEvent event;
+    event.issuer = issuer;
+    event.postings = std::move(postings);
+    return event;
+}
@@ -17,20 +17,25 @@
 
 #pragma once
 
+#include <vector>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/version.hpp>
 #include "util/IdManager.h"
 #include "util/NonCopyable.h"
 #include "util/NonMovable.h"
 #include "message/Mailbox.h"
 #include "city/Money.h"
+#include "city/Journal.h"
 
 class MessageBus;
 
 class Bank : public NonCopyable, public NonMovable
 {
 public:
+    // Only used to load old saves, the accounts are stored in parallel arrays
     struct Account
     {
-        enum Type{PERSON, COMPANY, WORLD};
+        enum Type{PERSON, COMPANY, WORLD, CLOSED};
         Id id;
         Id owner;
         Type type;
@@ -48,9 +53,15 @@ public:
         }
     };
 
+    struct Posting
+    {
+        Id receiver;
+        Money amount;
+    };
+
     struct Event
     {
-        enum class Type{CREATE_ACCOUNT, CLOSE_ACCOUNT, ACCOUNT_CREATED, TRANSFER_MONEY};
+        enum class Type{CREATE_ACCOUNT, CLOSE_ACCOUNT, ACCOUNT_CREATED, TRANSFER_MONEY, TRANSFER_MONEY_BATCH};
 
         struct CreateAccountEvent
         {
@@ -78,6 +89,15 @@ public:
         Event(Type type);
     };
 
+    // The message of a TRANSFER_MONEY_BATCH event contains this event, it must be read as one and not as an Event
+    struct TransferMoneyBatchEvent : public Event
+    {
+        Id issuer;
+        std::vector<Posting> postings;
+
+        TransferMoneyBatchEvent();
+    };
+
     Bank();
     ~Bank();
 
@@ -95,28 +115,80 @@ public:
 
     // Transfer
     void transferMoney(Id issuer, Id receiver, Money amount);
+    void transferMoney(Id issuer, const std::vector<Posting>& postings);
 
     // Taxes
     void collectTaxes(Id cityAccount, double incomeTax, double corporateTax);
 
+    // Journal
+    Journal& getJournal();
+    const Journal& getJournal() const;
+
     // Events
     Event createCreateAccountEvent(Account::Type type, Money funds) const;
     Event createCloseAccountEvent(Id account) const;
     Event createTransferMoneyEvent(Id issuer, Id receiver, Money amount) const;
     Event createAccountCreatedEvent(Id account) const;
+    TransferMoneyBatchEvent createTransferMoneyBatchEvent(Id issuer, std::vector<Posting> postings) const;
 
 private:
     MessageBus* mMessageBus;
     Mailbox mMailbox;
-    IdManager<Account> mAccounts;
+    // Accounts, indexed by the slots of their ids, the ids are generational like the ones of IdManager
+    std::vector<Id> mOwners;
+    std::vector<Account::Type> mTypes;
+    std::vector<Money> mBalances;
+    std::vector<Money> mPreviousBalances;
+    std::vector<std::uint32_t> mGenerations; // Incremented when the account of the slot is closed
+    std::vector<Id> mFreeIds; // Free slots
+    Journal mJournal;
+
+    Id addAccount(Id owner, Account::Type type, Money funds);
+    bool hasAccount(Id account) const; // False for the ids of closed accounts even if their slot is reused
+    void journalTaxes(std::size_t begin, std::size_t end, const double* rates, Id cityAccount); // Journal the taxes that collectTaxes collects in [begin, end)
+    Money collectTaxes(std::size_t begin, std::size_t end, const double* rates, Money cityBalance); // Tax the accounts in [begin, end) that must not contain the city account, return the city balance with their taxes
 
     // Serialization
     friend class boost::serialization::access;
 
     template<typename Archive>
-    void serialize(Archive& ar, const unsigned int /*version*/)
+    void save(Archive& ar, const unsigned int /*version*/) const
     {
-        ar & mMailbox & mAccounts;
+        ar & mMailbox;
+        ar & mOwners & mTypes & mBalances & mPreviousBalances & mFreeIds;
+        ar & mJournal;
+        ar & mGenerations;
     }
+
+    template<typename Archive>
+    void load(Archive& ar, const unsigned int version)
+    {
+        ar & mMailbox;
+        if (version >= 1)
+            ar & mOwners & mTypes & mBalances & mPreviousBalances & mFreeIds;
+        else
+        {
+            IdManager<Account> accounts;
+            ar & accounts;
+            loadAccounts(accounts);
+        }
+        if (version >= 2)
+            ar & mJournal;
+        // Ids of old saves have a null generation
+        if (version >= 3)
+            ar & mGenerations;
+        else
+            mGenerations.assign(mTypes.size(), 0);
+    }
+
+    void loadAccounts(const IdManager<Account>& accounts);
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
 };
 
+// Version 0: the accounts were saved in an IdManager
+// Version 1: the accounts are saved in parallel arrays
+// Version 2: journal
+// Version 3: generational ids
+BOOST_CLASS_VERSION(Bank, 3)
+
@@ -18,6 +18,7 @@
 #include "city/Building.h"
 #include "message/MessageBus.h"
 #include "render/sprite_intersection.h"
+#include "city/SpriteList.h"
 #include "city/Person.h"
 #include "city/Company.h"
 
@@ -34,33 +35,33 @@ Building::~Building()
         mOwner->getMessageBus()->removeMailbox(mMailbox);
 }
 
-void Building::draw(sf::RenderTarget& target, sf::RenderStates states) const
+bool Building::intersect(const sf::Vector2f& position) const
 {
-    target.draw(mSprite, states);
+    if (sprite_intersect(mSprite, *mMask, position))
+        return true;
     // Stairs
     sf::Sprite sprite(mSprite);
     sprite.setTextureRect(sf::IntRect(mSprite.getTextureRect().left, 0, 132, 85));
     for (unsigned int i = 0; i < mNbStairs - 1; ++i)
     {
         sprite.move(0, -STAIR_HEIGHT);
-        target.draw(sprite, states);
+        if (sprite_intersect(sprite, *mMask, position))
+            return true;
     }
+    return false;
 }
 
-bool Building::intersect(const sf::Vector2f& position) const
+void Building::takeSnapshot(SpriteList& sprites) const
 {
-    if (sprite_intersect(mSprite, *mMask, position))
-        return true;
+    sprites.addSprite(mSprite);
     // Stairs
     sf::Sprite sprite(mSprite);
     sprite.setTextureRect(sf::IntRect(mSprite.getTextureRect().left, 0, 132, 85));
     for (unsigned int i = 0; i < mNbStairs - 1; ++i)
     {
         sprite.move(0, -STAIR_HEIGHT);
-        if (sprite_intersect(sprite, *mMask, position))
-            return true;
+        sprites.addSprite(sprite);
     }
-    return false;
 }
 
 std::unique_ptr<Tile> Building::clone() const
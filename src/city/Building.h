@@ -33,8 +33,8 @@ public:
     Building(const std::string& name, Type type, unsigned int nbStairs);
     virtual ~Building();
 
-    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
     virtual bool intersect(const sf::Vector2f& position) const override;
+    virtual void takeSnapshot(SpriteList& sprites) const override;
     virtual std::unique_ptr<Tile> clone() const override;
     virtual void updateVariant(const Tile* neighbors[3][3]) override;
 
@@ -59,9 +59,8 @@ void Business::update()
     // Read messages
     bool priceDirty = false;
     bool desiredQuantityDirty = false;
-    while (!mMailbox.isEmpty())
+    mMailbox.drain([&](Message& message)
     {
-        Message message = mMailbox.get();
         if (message.type == MessageType::MARKET)
         {
             const MarketBase::EventBase& eventBase = message.getInfo<MarketBase::EventBase>();
@@ -111,7 +110,7 @@ void Business::update()
                     mOwner->getMessageBus()->send(Message::create(mMailbox.getId(), message.sender, MessageType::BUSINESS, Event{Event::Type::RESERVATION_REFUSED, {}, {}}));
             }
         }
-    }
+    });
 
     // Update price
     if (priceDirty)
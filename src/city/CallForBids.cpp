@@ -17,6 +17,7 @@
 
 #include "CallForBids.h"
 #include "resource/TextureManager.h"
+#include "city/SpriteList.h"
 
 CallForBids::CallForBids(const std::string& name, Type type, const sf::Color& signColor) :
     Tile(name, type, Category::CALL_FOR_BIDS), mSignColor(signColor)
@@ -24,11 +25,11 @@ CallForBids::CallForBids(const std::string& name, Type type, const sf::Color& si
     setUpSign();
 }
 
-void CallForBids::draw(sf::RenderTarget& target, sf::RenderStates states) const
+void CallForBids::takeSnapshot(SpriteList& sprites) const
 {
-    target.draw(mSprite, states);
+    sprites.addSprite(mSprite);
     // Sign
-    target.draw(mSignSprite, states);
+    sprites.addSprite(mSignSprite);
 }
 
 std::unique_ptr<Tile> CallForBids::clone() const
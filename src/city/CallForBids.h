@@ -25,7 +25,7 @@ class CallForBids : public Tile
 public:
     CallForBids(const std::string& name, Type type, const sf::Color& signColor);
 
-    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    virtual void takeSnapshot(SpriteList& sprites) const override;
 
     virtual std::unique_ptr<Tile> clone() const override;
 
@@ -15,8 +15,10 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cmath>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include "city/Car.h"
+#include "city/SpriteList.h"
 #include "resource/TextureManager.h"
 #include "resource/ImageManager.h"
 
@@ -33,14 +35,9 @@ void Car::setImageManager(ImageManager* imageManager)
     sImageManager = imageManager;
 }
 
-Car::Car(std::string model) :
-    mModel(std::move(model)), mKinematic(1.0f, 150.0f), mSteering(&mKinematic),
-    mMask(nullptr), mDriver(nullptr)
+Car::Car(std::uint32_t model) : mMask(nullptr), mDriver(nullptr)
 {
-    mSteering.setSeekDistance(4.0f);
-    mSteering.setArriveDistance(4.0f);
-
-    setUp();
+    reset(model);
 }
 
 void Car::draw(sf::RenderTarget& target, sf::RenderStates states) const
@@ -55,20 +52,27 @@ void Car::draw(sf::RenderTarget& target, sf::RenderStates states) const
     target.draw(mSprite, states);
 }
 
-void Car::update(float dt)
+void Car::reset(std::uint32_t model)
 {
-    Vector2f steeringForce = mSteering.compute(dt);
-    mKinematic.addForce(steeringForce);
-    mKinematic.update(dt);
+    mModel = model;
+    mKinematic = Kinematic(1.0f, 150.0f);
+    mSteering = SteeringBehaviors(&mKinematic);
+    mSteering.setSeekDistance(4.0f);
+    mSteering.setArriveDistance(4.0f);
 
+    setUp();
+}
+
+void Car::updateSprite()
+{
     mSprite.setPosition(mKinematic.getPosition());
-    float angle = toDegrees(mKinematic.getDirection().angle());
-    if (angle >= 0.0f)
-        angle = 360.0f - angle;
-    else
-        angle = -angle;
-    int i = static_cast<int>((angle + 22.5f) / 45.0f) % 8;
-    mSprite.setTextureRect(sf::IntRect(i * mWidth, 0, mWidth, mHeight));
+    // Only change the texture rect if the heading changes
+    int heading = computeHeading();
+    if (heading != mHeading)
+    {
+        mHeading = heading;
+        mSprite.setTextureRect(sf::IntRect(mHeading * mWidth, 0, mWidth, mHeight));
+    }
 }
 
 bool Car::intersect(const sf::Vector2f& position) const
@@ -76,6 +80,11 @@ bool Car::intersect(const sf::Vector2f& position) const
     return sprite_intersect(mSprite, *mMask, position);
 }
 
+void Car::takeSnapshot(SpriteList& sprites) const
+{
+    sprites.addSprite(mSprite);
+}
+
 Kinematic& Car::getKinematic()
 {
     return mKinematic;
@@ -96,6 +105,11 @@ sf::FloatRect Car::getBounds() const
     return mSprite.getGlobalBounds();
 }
 
+std::uint32_t Car::getModel() const
+{
+    return mModel;
+}
+
 Person* Car::getDriver()
 {
     return mDriver;
@@ -113,14 +127,33 @@ void Car::setDriver(Person* owner)
 
 void Car::setUp()
 {
-    mMask = &sImageManager->getImage(mModel);
+    const std::string& model = PersonGenerator::getCarModels().get(mModel);
+    mMask = &sImageManager->getImage(model);
 
-    const sf::Texture& texture = sTextureManager->getTexture(mModel);
+    const sf::Texture& texture = sTextureManager->getTexture(model);
     mWidth = texture.getSize().x / 8;
     mHeight = texture.getSize().y;
 
     mSprite.setTexture(texture);
+    mHeading = 0;
     mSprite.setTextureRect(sf::IntRect(0, 0, mWidth, mHeight));
     mSprite.setOrigin(sf::Vector2f(mWidth * 0.5f, mHeight * 0.5f));
 }
 
+int Car::computeHeading() const
+{
+    // Nearest multiple of 45 degrees of the clockwise angle of the direction, without atan2
+    constexpr float TAN_22_5 = 0.41421356f;
+    float x = mKinematic.getDirection().x;
+    float y = -mKinematic.getDirection().y;
+    float absX = std::abs(x);
+    float absY = std::abs(y);
+    if (absY <= TAN_22_5 * absX)
+        return x >= 0.0f ? 0 : 4;
+    else if (absX <= TAN_22_5 * absY)
+        return y >= 0.0f ? 2 : 6;
+    else if (x >= 0.0f)
+        return y >= 0.0f ? 1 : 7;
+    else
+        return y >= 0.0f ? 3 : 5;
+}
@@ -17,15 +17,18 @@
 
 #pragma once
 
+#include <cstdint>
 #include <boost/serialization/split_member.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include "ai/Kinematic.h"
 #include "ai/SteeringBehaviors.h"
 #include "render/sprite_intersection.h"
+#include "pcg/PersonGenerator.h"
 
 class TextureManager;
 class ImageManager;
 class Person;
+class SpriteList;
 
 class Car : public sf::Drawable
 {
@@ -34,17 +37,20 @@ public:
     static void setImageManager(ImageManager* imageManager);
 
     Car() = default; // Only for serialization
-    Car(std::string model);
+    Car(std::uint32_t model); // Index in the car models of PersonGenerator
 
     virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
-    void update(float dt);
+    void reset(std::uint32_t model);
+    void updateSprite(); // Must be called when the kinematic changes
     bool intersect(const sf::Vector2f& position) const;
+    void takeSnapshot(SpriteList& sprites) const; // Add the sprite drawn by draw
 
     Kinematic& getKinematic();
     const Kinematic& getKinematic() const;
     SteeringBehaviors& getSteering();
     sf::FloatRect getBounds() const;
+    std::uint32_t getModel() const;
     Person* getDriver();
     const Person* getDriver() const;
     void setDriver(Person* owner);
@@ -53,16 +59,18 @@ private:
     static TextureManager* sTextureManager;
     static ImageManager* sImageManager;
 
-    std::string mModel;
+    std::uint32_t mModel;
     int mWidth;
     int mHeight;
     Kinematic mKinematic;
     SteeringBehaviors mSteering;
     sf::Sprite mSprite;
+    int mHeading; // One of the 8 directions of the sprite sheet
     const sf::Image* mMask;
     Person* mDriver;
 
     void setUp();
+    int computeHeading() const;
 
     // Serialization
     friend class boost::serialization::access;
@@ -70,13 +78,17 @@ private:
     template<typename Archive>
     void save(Archive& ar, const unsigned int /*version*/) const
     {
-        ar & mModel & mKinematic & mSteering & mDriver;
+        // The model is saved by name so that saves do not depend on the order of the models
+        std::string model = PersonGenerator::getCarModels().get(mModel);
+        ar & model & mKinematic & mSteering & mDriver;
     }
 
     template<typename Archive>
     void load(Archive& ar, const unsigned int /*version*/)
     {
-        ar & mModel & mKinematic & mSteering & mDriver;
+        std::string model;
+        ar & model & mKinematic & mSteering & mDriver;
+        mModel = PersonGenerator::getCarModels().add(model);
         setUp();
     }
 
@@ -0,0 +1,259 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "city/CarPool.h"
+#include <algorithm>
+#include <cmath>
+#include "city/Car.h"
+#include "city/City.h"
+
+namespace
+{
+
+// Same computations as SteeringBehaviors::compute followed by Kinematic::update
+// The loop has no calls and only selects between computed values, and the arrays are
+// passed as restricted parameters so that the compiler can vectorize it
+void integrateKinematics(std::size_t size, float dt,
+    const float* __restrict targetsX,
+    const float* __restrict targetsY,
+    const float* __restrict hasTargets,
+    const float* __restrict arrivings,
+    const float* __restrict arriveDistances,
+    const float* __restrict masses,
+    const float* __restrict maxSpeeds,
+    const float* __restrict maxForces,
+    float* __restrict positionsX,
+    float* __restrict positionsY,
+    float* __restrict velocitiesX,
+    float* __restrict velocitiesY,
+    float* __restrict directionsX,
+    float* __restrict directionsY,
+    float* __restrict movings)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        // Desired velocity: seek the target or arrive at it
+        float toTargetX = targetsX[i] - positionsX[i];
+        float toTargetY = targetsY[i] - positionsY[i];
+        float distance = std::sqrt(toTargetX * toTargetX + toTargetY * toTargetY);
+        float arriveSpeed = std::min(1.0f, distance / arriveDistances[i]) * maxSpeeds[i];
+        float speed = arrivings[i] > 0.0f ? arriveSpeed : maxSpeeds[i];
+        float hasTarget = hasTargets[i] * (distance >= EPSILON ? 1.0f : 0.0f);
+        float factor = hasTarget * speed / std::max(distance, EPSILON);
+        // Steering force
+        float forceX = (factor * toTargetX - velocitiesX[i]) * masses[i] / dt;
+        float forceY = (factor * toTargetY - velocitiesY[i]) * masses[i] / dt;
+        float force = std::sqrt(forceX * forceX + forceY * forceY);
+        float forceScale = std::min(1.0f, maxForces[i] / std::max(force, EPSILON));
+        // Integration
+        float velocityX = velocitiesX[i] + forceScale * forceX / masses[i] * dt;
+        float velocityY = velocitiesY[i] + forceScale * forceY / masses[i] * dt;
+        float squaredVelocity = velocityX * velocityX + velocityY * velocityY;
+        float velocity = std::sqrt(squaredVelocity);
+        float velocityScale = std::min(1.0f, maxSpeeds[i] / std::max(velocity, EPSILON));
+        velocityX *= velocityScale;
+        velocityY *= velocityScale;
+        velocitiesX[i] = velocityX;
+        velocitiesY[i] = velocityY;
+        positionsX[i] += velocityX * dt;
+        positionsY[i] += velocityY * dt;
+        // Direction
+        float moving = squaredVelocity * velocityScale * velocityScale >= EPSILON ? 1.0f : 0.0f;
+        float inverseVelocity = moving / std::max(velocity * velocityScale, EPSILON);
+        directionsX[i] = velocityX * inverseVelocity;
+        directionsY[i] = velocityY * inverseVelocity;
+        movings[i] = moving;
+    }
+}
+
+}
+
+CarPool::CarPool()
+{
+
+}
+
+CarPool::~CarPool()
+{
+
+}
+
+Car* CarPool::checkOut(std::uint32_t model, Person* driver)
+{
+    Car* car;
+    if (mFreeCars.empty())
+    {
+        mCars.push_back(std::make_unique<Car>(model));
+        car = mCars.back().get();
+    }
+    else
+    {
+        car = mFreeCars.back();
+        mFreeCars.pop_back();
+        car->reset(model);
+    }
+    car->setDriver(driver);
+    return car;
+}
+
+void CarPool::checkIn(Car* car)
+{
+    car->setDriver(nullptr);
+    mFreeCars.push_back(car);
+}
+
+void CarPool::adopt(Car* car)
+{
+    mCars.emplace_back(car);
+}
+
+TaskScheduler::TaskId CarPool::addTasks(TaskScheduler& scheduler, float dt, const City& city, TaskScheduler::TaskId dependency)
+{
+    TaskScheduler::TaskId selection = scheduler.addTask("cars selection", [this, &city]{ select(city); }, {dependency});
+    TaskScheduler::TaskId offscreen = scheduler.addParallelTask("cars off-screen",
+        [this]{ return mOffscreenCars.size(); }, CHUNK_SIZE,
+        [this, dt](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+                advanceAlongPath(mOffscreenCars[i], dt);
+        }, {selection});
+    TaskScheduler::TaskId gathering = scheduler.addParallelTask("cars gather",
+        [this]{ return mBatch.size; }, CHUNK_SIZE,
+        [this](std::size_t begin, std::size_t end){ gather(begin, end); }, {selection});
+    TaskScheduler::TaskId integration = scheduler.addParallelTask("cars integration",
+        [this]{ return mBatch.size; }, CHUNK_SIZE,
+        [this, dt](std::size_t begin, std::size_t end){ integrate(dt, begin, end); }, {gathering});
+    return scheduler.addParallelTask("cars scatter",
+        [this]{ return mBatch.size; }, CHUNK_SIZE,
+        [this](std::size_t begin, std::size_t end){ scatter(begin, end); }, {integration, offscreen});
+}
+
+std::size_t CarPool::getNbCars() const
+{
+    return mCars.size();
+}
+
+std::size_t CarPool::getNbCheckedOutCars() const
+{
+    return mCars.size() - mFreeCars.size();
+}
+
+void CarPool::Batch::resize(std::size_t newSize)
+{
+    size = newSize;
+    for (std::vector<float>* array : {&positionsX, &positionsY, &velocitiesX, &velocitiesY,
+        &targetsX, &targetsY, &hasTargets, &arrivings, &arriveDistances, &masses, &maxSpeeds,
+        &maxForces, &directionsX, &directionsY, &movings})
+        array->resize(size);
+}
+
+void CarPool::select(const City& city)
+{
+    mBatchCars.clear();
+    mOffscreenCars.clear();
+    for (std::unique_ptr<Car>& car : mCars)
+    {
+        if (car->getDriver())
+        {
+            if (city.isVisible(car->getKinematic().getPosition()))
+                mBatchCars.push_back(car.get());
+            else
+                mOffscreenCars.push_back(car.get());
+        }
+    }
+
+    mBatch.resize(mBatchCars.size());
+}
+
+void CarPool::gather(std::size_t begin, std::size_t end)
+{
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        Kinematic& kinematic = mBatchCars[i]->getKinematic();
+        SteeringBehaviors& steering = mBatchCars[i]->getSteering();
+        const Vector2f& position = kinematic.getPosition();
+        mBatch.positionsX[i] = position.x;
+        mBatch.positionsY[i] = position.y;
+        mBatch.velocitiesX[i] = kinematic.getVelocity().x;
+        mBatch.velocitiesY[i] = kinematic.getVelocity().y;
+        mBatch.masses[i] = kinematic.getMass();
+        mBatch.maxSpeeds[i] = kinematic.getMaxSpeed();
+        mBatch.maxForces[i] = kinematic.getMaxForce();
+        mBatch.arriveDistances[i] = steering.getArriveDistance();
+        // Advance on the path, same rules as SteeringBehaviors::followPath
+        Path& path = steering.getPath();
+        if (path.isEmpty())
+        {
+            mBatch.targetsX[i] = position.x;
+            mBatch.targetsY[i] = position.y;
+            mBatch.hasTargets[i] = 0.0f;
+            mBatch.arrivings[i] = 0.0f;
+        }
+        else
+        {
+            bool finished = path.isFinished();
+            float seekDistance = steering.getSeekDistance();
+            if (!finished && position.squaredDistanceTo(path.getCurrentPoint()) < seekDistance * seekDistance)
+                path.setNextPoint();
+            Vector2f target = path.getCurrentPoint();
+            mBatch.targetsX[i] = target.x;
+            mBatch.targetsY[i] = target.y;
+            mBatch.hasTargets[i] = 1.0f;
+            mBatch.arrivings[i] = finished;
+        }
+    }
+}
+
+void CarPool::advanceAlongPath(Car* car, float dt)
+{
+    car->getSteering().advanceAlongPath(dt);
+    car->updateSprite();
+}
+
+void CarPool::integrate(float dt, std::size_t begin, std::size_t end)
+{
+    integrateKinematics(end - begin, dt,
+        mBatch.targetsX.data() + begin,
+        mBatch.targetsY.data() + begin,
+        mBatch.hasTargets.data() + begin,
+        mBatch.arrivings.data() + begin,
+        mBatch.arriveDistances.data() + begin,
+        mBatch.masses.data() + begin,
+        mBatch.maxSpeeds.data() + begin,
+        mBatch.maxForces.data() + begin,
+        mBatch.positionsX.data() + begin,
+        mBatch.positionsY.data() + begin,
+        mBatch.velocitiesX.data() + begin,
+        mBatch.velocitiesY.data() + begin,
+        mBatch.directionsX.data() + begin,
+        mBatch.directionsY.data() + begin,
+        mBatch.movings.data() + begin);
+}
+
+void CarPool::scatter(std::size_t begin, std::size_t end)
+{
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        Kinematic& kinematic = mBatchCars[i]->getKinematic();
+        kinematic.setPosition(Vector2f(mBatch.positionsX[i], mBatch.positionsY[i]));
+        kinematic.setVelocity(Vector2f(mBatch.velocitiesX[i], mBatch.velocitiesY[i]));
+        if (mBatch.movings[i] > 0.0f)
+            kinematic.setDirection(Vector2f(mBatch.directionsX[i], mBatch.directionsY[i]));
+        mBatchCars[i]->updateSprite();
+    }
+}
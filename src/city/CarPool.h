@@ -0,0 +1,90 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "util/NonCopyable.h"
+#include "util/NonMovable.h"
+#include "util/TaskScheduler.h"
+
+class Car;
+class City;
+class Person;
+
+// Cars are only needed by the persons that are driving
+// The pool reuses them so that the memory scales with the number of drivers
+class CarPool : public NonCopyable, public NonMovable
+{
+public:
+    CarPool();
+    ~CarPool();
+
+    Car* checkOut(std::uint32_t model, Person* driver);
+    void checkIn(Car* car);
+    void adopt(Car* car); // Takes the ownership of a car loaded from a save, the car is checked out
+
+    // Add the tasks that move all the checked out cars after dependency, the last task is returned
+    // The cars that are not visible in the city are moved along their path at max speed,
+    // without integrating the steering forces
+    // Each car is only accessed by one chunk so the chunks run in parallel
+    TaskScheduler::TaskId addTasks(TaskScheduler& scheduler, float dt, const City& city, TaskScheduler::TaskId dependency);
+
+    std::size_t getNbCars() const;
+    std::size_t getNbCheckedOutCars() const;
+
+private:
+    static constexpr std::size_t CHUNK_SIZE = 256;
+
+    // State of the checked out cars during the update, one element per car
+    struct Batch
+    {
+        std::size_t size = 0;
+        std::vector<float> positionsX;
+        std::vector<float> positionsY;
+        std::vector<float> velocitiesX;
+        std::vector<float> velocitiesY;
+        std::vector<float> targetsX;
+        std::vector<float> targetsY;
+        std::vector<float> hasTargets; // 1 if the car follows a path, 0 otherwise
+        std::vector<float> arrivings; // 1 if the target is the last point of the path, 0 otherwise
+        std::vector<float> arriveDistances;
+        std::vector<float> masses;
+        std::vector<float> maxSpeeds;
+        std::vector<float> maxForces;
+        std::vector<float> directionsX;
+        std::vector<float> directionsY;
+        std::vector<float> movings; // 1 if the direction changed, 0 otherwise
+
+        void resize(std::size_t newSize);
+    };
+
+    std::vector<std::unique_ptr<Car>> mCars;
+    std::vector<Car*> mFreeCars;
+    std::vector<Car*> mBatchCars;
+    std::vector<Car*> mOffscreenCars;
+    Batch mBatch;
+
+    void select(const City& city);
+    void gather(std::size_t begin, std::size_t end);
+    void advanceAlongPath(Car* car, float dt);
+    void integrate(float dt, std::size_t begin, std::size_t end);
+    void scatter(std::size_t begin, std::size_t end);
+};
@@ -18,11 +18,13 @@
 #include "City.h"
 #include <fstream>
 #include <sstream>
+#include <thread>
 #include "city/Market.h"
 #include "city/Company.h"
 #include "city/Building.h"
 #include "city/Person.h"
 #include "city/Good.h"
+#include "city/CitySnapshot.h"
 
 constexpr Money City::SEED_MONEY; // Could be removed in C++17
 
@@ -69,9 +71,10 @@ City::Event::Event(Building* building) : type(Type::BUILDING_DESTROYED), buildin
 City::City() :
     mTerrainGenerator(mRandomGenerator), mPersonGenerator(mRandomGenerator),
     mCompanyGenerator(mRandomGenerator), mNewspaperGenerator(mRandomGenerator),
-    mCurrentTime(0.0), mTimePerMonth(20.0f), mMonth(0), mYear(0),
+    mCurrentTime(0.0), mTimePerMonth(20.0f), mMonth(0), mYear(0), mNbUpdatesInMonth(0), mStaggeredMonths(true),
     mCityCompany(std::make_unique<Company>("City", 0, nullptr, SEED_MONEY)),
-    mWeeklyStandardWorkingHours(0), mMinimumWage(0.0), mIncomeTax(0.0f), mCorporateTax(0.0f)
+    mWeeklyStandardWorkingHours(0), mMinimumWage(0.0), mIncomeTax(0.0f), mCorporateTax(0.0f),
+    mBatchArbitration(true), mStatisticsDay(0), mScheduler(std::thread::hardware_concurrency())
 {
 
 }
@@ -84,9 +87,39 @@ City::~City()
 
 void City::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
-    // Compute the bounds
+    sf::IntRect bounds = computeVisibleTiles(target.getView());
+    const Array2<std::unique_ptr<Tile>>& tiles = mMap.getTiles();
+    for (int i = bounds.top; i < bounds.top + bounds.height; ++i)
+    {
+        for (int j = bounds.left; j < bounds.left + bounds.width; ++j)
+        {
+            target.draw(*tiles.get(i, j), states);
+            for (const Car* car : mCarsByTile.get(i, j))
+                target.draw(*car, states);
+        }
+    }
+}
+
+void City::takeSnapshot(const sf::View& view, CitySnapshot& snapshot)
+{
+    mVisibleTiles = computeVisibleTiles(view);
+    snapshot.clear();
+    snapshot.setInfo(getPrettyDate(), getFunds(), getPopulation(), getAverageHappiness());
+    const Array2<std::unique_ptr<Tile>>& tiles = mMap.getTiles();
+    for (int i = mVisibleTiles.top; i < mVisibleTiles.top + mVisibleTiles.height; ++i)
+    {
+        for (int j = mVisibleTiles.left; j < mVisibleTiles.left + mVisibleTiles.width; ++j)
+        {
+            tiles.get(i, j)->takeSnapshot(snapshot);
+            for (const Car* car : mCarsByTile.get(i, j))
+                car->takeSnapshot(snapshot);
+        }
+    }
+}
+
+sf::IntRect City::computeVisibleTiles(const sf::View& view) const
+{
     int margin = 3;
-    sf::View view = target.getView();
     sf::Vector2f topLeft = view.getCenter() - view.getSize() * 0.5f;
     sf::Vector2i iTopLeft = toTileIndices(topLeft);
     sf::Vector2f topRight(view.getCenter().x + 0.5f * view.getSize().x, view.getCenter().y - 0.5f * view.getSize().y);
@@ -101,103 +134,62 @@ void City::draw(sf::RenderTarget& target, sf::RenderStates states) const
     unsigned int iMax = std::min(std::max(iBounds.second + margin + 1, 0), static_cast<int>(mMap.getHeight()));
     unsigned int jMin = std::max(jBounds.first - margin, 0);
     unsigned int jMax = std::min(std::max(jBounds.second + margin + 1, 0), static_cast<int>(mMap.getWidth()));
-
-    // Draw
-    const Array2<std::unique_ptr<Tile>>& tiles = mMap.getTiles();
-    for (unsigned int i = iMin; i < iMax; ++i)
-    {
-        for (unsigned int j = jMin; j < jMax; ++j)
-        {
-            target.draw(*tiles.get(i, j), states);
-            for (const Car* car : mCarsByTile.get(i, j))
-                target.draw(*car, states);
-        }
-    }
+    return sf::IntRect(jMin, iMin, jMax - jMin, iMax - iMin);
 }
 
 void City::update(float dt)
 {
-    // Read messages
-    while (!mMailbox.isEmpty())
-    {
-        Message message = mMailbox.get();
-        if (message.type == MessageType::CITY)
-        {
-            const City::Event& event = message.getInfo<City::Event>();
-            switch (event.type)
-            {
-                case City::Event::Type::REMOVE_CITIZEN:
-                    removeCitizen(event.person);
-                    break;
-                default:
-                    break;
-            }
-        }
-    }
-
-    // Update the citizens
-    for (Person* citizen : mCitizens)
-        citizen->update(dt);
+    mCityMessageBus.tick();
+    ++mNbUpdatesInMonth;
 
-    // Update the companies
-    mCityCompany->update(dt);
-    for (std::unique_ptr<Company>& company : mCompanies)
-        company->update(dt);
-
-    // Update markets
-    for (std::unique_ptr<MarketBase>& market : mMarkets)
-        market->update();
-
-    // Update bank
-    mBank.update();
-
-    // Update the date
-    mTotalTime += dt;
-    mCurrentTime += dt;
-    while (mCurrentTime >= mTimePerMonth)
+    // The phases that send messages or use the pools of goals and cars run one after the other
+    // The cars, the inputs of the arbitration, the sort of the cars and the statistics run in parallel
+    TaskScheduler::TaskId messages = mScheduler.addTask("messages", [this]{ readMessages(); });
+    TaskScheduler::TaskId citizens = mScheduler.addTask("citizens", [this, dt]
     {
-        mCurrentTime -= mTimePerMonth;
-        ++mMonth;
-        onNewMonth();
-    }
-
-    // Update the map
-    for (unsigned int i = 0; i < mMap.getHeight(); ++i)
+        for (Person* citizen : mCitizens)
+            citizen->update(dt);
+    }, {messages});
+    TaskScheduler::TaskId arbitration = mGoalArbiter.addTasks(mScheduler, mCitizens, citizens);
+    // The cars are moved while the companies are updated
+    TaskScheduler::TaskId cars = mCarPool.addTasks(mScheduler, dt, *this, arbitration);
+    TaskScheduler::TaskId companies = mScheduler.addTask("companies", [this, dt]
     {
-        for (unsigned int j = 0; j < mMap.getWidth(); ++j)
-            mCarsByTile.get(i, j).clear();
-    }
-    for (Person* citizen : mCitizens)
+        mCityCompany->update(dt);
+        for (std::unique_ptr<Company>& company : mCompanies)
+            company->update(dt);
+    }, {arbitration});
+    TaskScheduler::TaskId markets = mScheduler.addTask("markets", [this]
     {
-        if (citizen->getState() == Person::State::VISIBLE)
-        {
-            const Car& car = citizen->getCar();
-            sf::Vector2f bottomLeft(car.getBounds().left, car.getBounds().top + car.getBounds().height);
-            sf::Vector2f bottomRight(bottomLeft.x + car.getBounds().width, bottomLeft.y);
-            sf::Vector2i iBottomLeft = toTileIndices(bottomLeft);
-            sf::Vector2i iBottomRight = toTileIndices(bottomRight);
-            sf::Vector2i indices(std::max(iBottomLeft.x, iBottomRight.x), std::max(iBottomLeft.y, iBottomRight.y));
-            if (indices.y >= 0 && indices.y < static_cast<int>(mCarsByTile.getHeight()) &&
-                indices.x >= 0 && indices.x < static_cast<int>(mCarsByTile.getWidth()))
-                mCarsByTile.get(indices.y, indices.x).push_back(&car);
-        }
-    }
-    // Sort the cars
-    for (unsigned int i = 0; i < mMap.getHeight(); ++i)
+        for (std::unique_ptr<MarketBase>& market : mMarkets)
+            market->update();
+    }, {companies});
+    TaskScheduler::TaskId bank = mScheduler.addTask("bank", [this]{ mBank.update(); }, {markets});
+
+    // Update the date
+    // The date is only changed by these tasks so the months that end are known in advance
+    TaskScheduler::TaskId date = mScheduler.addTask("date", [this, dt]
     {
-        for (unsigned int j = 0; j < mMap.getWidth(); ++j)
-            std::sort(mCarsByTile.get(i, j).begin(), mCarsByTile.get(i, j).end(), [](const Car* car1, const Car* car2) { return car1->getBounds().top < car2->getBounds().top; });
-    }
+        mTotalTime += dt;
+        mCurrentTime += dt;
+    }, {bank, cars});
+    for (float currentTime = mCurrentTime + dt; currentTime >= mTimePerMonth; currentTime -= mTimePerMonth)
+        date = addNewMonthTasks(date);
+
+    // Update the map and the statistics
+    TaskScheduler::TaskId carsByTile = mScheduler.addTask("cars by tile", [this]{ updateCarsByTile(); }, {date});
+    mScheduler.addParallelTask("cars by tile sort", [this]{ return mCarsByTile.getHeight(); }, 8,
+        [this](std::size_t begin, std::size_t end){ sortCarsByTile(begin, end); }, {carsByTile});
+    mScheduler.addTask("statistics", [this]{ updateStatistics(); }, {date});
 
-    // Update statistics
-    updateStatistics();
+    mScheduler.run();
 }
 
 void City::setGameMessageBus(MessageBus* messageBus)
 {
-    setSubjectMessageBus(messageBus);
+    setSubjectMessageBus(messageBus, true);
     for (std::unique_ptr<MarketBase>& market : mMarkets)
-        market->setSubjectMessageBus(messageBus);
+        market->setSubjectMessageBus(messageBus, true);
 }
 
 Id City::getMailboxId() const
@@ -205,6 +197,16 @@ Id City::getMailboxId() const
     return mMailbox.getId();
 }
 
+const Channel& City::getChannel() const
+{
+    return mChannel;
+}
+
+const MessageBusStatistics& City::getMessageBusStatistics() const
+{
+    return mCityMessageBus.getStatistics();
+}
+
 const std::string& City::getName() const
 {
     return mName;
@@ -246,7 +248,7 @@ void City::bulldoze(Tile::Type type)
     mMap.bulldoze(type, *mCityCompany, mBuildings, buildingsToRemove);
     // Notify the changes
     for (Id id : buildingsToRemove)
-        notify(Message::create(MessageType::CITY, Event(getBuilding(id))));
+        notify(Message::create(MessageType::CITY, Event(getBuilding(id))), topics(Event::Type::BUILDING_DESTROYED));
     // Destroy the buildings
     for (Id id : buildingsToRemove)
         mBuildings.erase(id);
@@ -299,6 +301,23 @@ unsigned int City::getYear() const
     return mYear;
 }
 
+bool City::areMonthsStaggered() const
+{
+    return mStaggeredMonths;
+}
+
+void City::setMonthsStaggered(bool staggered)
+{
+    mStaggeredMonths = staggered;
+}
+
+bool City::isMonthPhaseReached(Id mailboxId) const
+{
+    // The low bits of an id are the index of its slot, they are dense so the phases are evenly spread
+    unsigned int phase = static_cast<std::uint32_t>(mailboxId) % NB_MONTH_SLICES;
+    return !mStaggeredMonths || mNbUpdatesInMonth > phase;
+}
+
 std::string City::getFormattedMonth() const
 {
     switch (mMonth)
@@ -337,6 +356,11 @@ std::string City::getPrettyDate() const
     return getFormattedMonth() + ' ' + std::to_string(2000 + mYear);
 }
 
+Bank& City::getBank()
+{
+    return mBank;
+}
+
 const Bank& City::getBank() const
 {
     return mBank;
@@ -357,6 +381,31 @@ const Newspaper& City::getNewspaper() const
     return mNewspaper;
 }
 
+bool City::isBatchArbitrationEnabled() const
+{
+    return mBatchArbitration;
+}
+
+void City::setBatchArbitrationEnabled(bool enabled)
+{
+    mBatchArbitration = enabled;
+}
+
+std::size_t City::getNbThreads() const
+{
+    return mScheduler.getNbThreads();
+}
+
+void City::setNbThreads(std::size_t nbThreads)
+{
+    mScheduler.setNbThreads(nbThreads);
+}
+
+const TaskScheduler& City::getScheduler() const
+{
+    return mScheduler;
+}
+
 Company& City::getCompany()
 {
     return *mCityCompany;
@@ -391,9 +440,7 @@ void City::setMinimumWage(Money minimumWage)
 {
     mMinimumWage = minimumWage;
     // Send messages
-    mCityMessageBus.send(Message::create(mCityCompany->getMailboxId(), MessageType::CITY, Event(mMinimumWage)));
-    for (std::unique_ptr<Company>& company : mCompanies)
-        mCityMessageBus.send(Message::create(company->getMailboxId(), MessageType::CITY, Event(mMinimumWage)));
+    mChannel.publish(Message::create(MessageType::CITY, Event(mMinimumWage)));
 }
 
 double City::getIncomeTax() const
@@ -423,7 +470,7 @@ void City::eject(Person* person)
     mTimeBeforeLeaving.erase(mTimeBeforeLeaving.begin() + i);
     mPersons.erase(person->getId());
     // Notify
-    notify(Message::create(MessageType::CITY, Event(Event::Type::IMMIGRANT_EJECTED, person)));
+    notify(Message::create(MessageType::CITY, Event(Event::Type::IMMIGRANT_EJECTED, person)), topics(Event::Type::IMMIGRANT_EJECTED));
 }
 
 void City::ejectAll()
@@ -439,9 +486,9 @@ void City::welcome(Person* person)
     mImmigrants.erase(mImmigrants.begin() + i);
     mTimeBeforeLeaving.erase(mTimeBeforeLeaving.begin() + i);
     mCitizens.push_back(person);
-    person->setCity(this, &mCityMessageBus);
+    person->setCity(this, &mCityMessageBus, &mCarPool);
     // Notify
-    notify(Message::create(MessageType::CITY, Event(Event::Type::NEW_CITIZEN, person)));
+    notify(Message::create(MessageType::CITY, Event(Event::Type::NEW_CITIZEN, person)), topics(Event::Type::NEW_CITIZEN));
 }
 
 void City::welcomeAll()
@@ -486,6 +533,13 @@ float City::getAttractiveness() const
     return mAttractiveness;
 }
 
+void City::writeGoalAllocationsCsv(std::ostream& os) const
+{
+    os << "day,goals,heap goals\n";
+    for (const GoalAllocations& allocations : mGoalAllocations)
+        os << allocations.day << ',' << allocations.nbAllocations << ',' << allocations.nbHeapAllocations << '\n';
+}
+
 sf::Vector2i City::toTileIndices(const sf::Vector2f& position) const
 {
     int x = position.y / Tile::HEIGHT + 0.5f * (position.x / Tile::HEIGHT - mMap.getWidth() - 1);
@@ -493,6 +547,12 @@ sf::Vector2i City::toTileIndices(const sf::Vector2f& position) const
     return sf::Vector2i(x, y);
 }
 
+bool City::isVisible(const sf::Vector2f& position) const
+{
+    sf::Vector2i indices = toTileIndices(position);
+    return mVisibleTiles.contains(indices);
+}
+
 float City::getHumanTime() const
 {
     return mTotalTime;
@@ -518,6 +578,58 @@ float City::toCityTime(float humanTime) const
     return humanTime / mTimePerMonth * NB_HOURS_PER_MONTH;
 }
 
+void City::readMessages()
+{
+    mMailbox.drain([&](Message& message)
+    {
+        if (message.type == MessageType::CITY)
+        {
+            const City::Event& event = message.getInfo<City::Event>();
+            switch (event.type)
+            {
+                case City::Event::Type::REMOVE_CITIZEN:
+                    removeCitizen(event.person);
+                    break;
+                default:
+                    break;
+            }
+        }
+    });
+}
+
+void City::updateCarsByTile()
+{
+    for (unsigned int i = 0; i < mMap.getHeight(); ++i)
+    {
+        for (unsigned int j = 0; j < mMap.getWidth(); ++j)
+            mCarsByTile.get(i, j).clear();
+    }
+    for (Person* citizen : mCitizens)
+    {
+        const Car* car = citizen->getCar();
+        if (car)
+        {
+            sf::Vector2f bottomLeft(car->getBounds().left, car->getBounds().top + car->getBounds().height);
+            sf::Vector2f bottomRight(bottomLeft.x + car->getBounds().width, bottomLeft.y);
+            sf::Vector2i iBottomLeft = toTileIndices(bottomLeft);
+            sf::Vector2i iBottomRight = toTileIndices(bottomRight);
+            sf::Vector2i indices(std::max(iBottomLeft.x, iBottomRight.x), std::max(iBottomLeft.y, iBottomRight.y));
+            if (indices.y >= 0 && indices.y < static_cast<int>(mCarsByTile.getHeight()) &&
+                indices.x >= 0 && indices.x < static_cast<int>(mCarsByTile.getWidth()))
+                mCarsByTile.get(indices.y, indices.x).push_back(car);
+        }
+    }
+}
+
+void City::sortCarsByTile(std::size_t firstRow, std::size_t lastRow)
+{
+    for (std::size_t i = firstRow; i < lastRow; ++i)
+    {
+        for (unsigned int j = 0; j < mMap.getWidth(); ++j)
+            std::sort(mCarsByTile.get(i, j).begin(), mCarsByTile.get(i, j).end(), [](const Car* car1, const Car* car2) { return car1->getBounds().top < car2->getBounds().top; });
+    }
+}
+
 void City::updateImmigrants()
 {
     // Update immigrants
@@ -543,7 +655,7 @@ void City::generateImmigrant()
     Id id = mPersons.add(std::move(person));
     mImmigrants.back()->setId(id);
     // Notify
-    notify(Message::create(MessageType::CITY, Event(Event::Type::NEW_IMMIGRANT, mImmigrants.back())));
+    notify(Message::create(MessageType::CITY, Event(Event::Type::NEW_IMMIGRANT, mImmigrants.back())), topics(Event::Type::NEW_IMMIGRANT));
 }
 
 void City::removeCitizen(Person* person)
@@ -551,13 +663,16 @@ void City::removeCitizen(Person* person)
     mCitizens.erase(std::find(mCitizens.begin(), mCitizens.end(), person));
     mPersons.erase(person->getId());
     // Notify
-    notify(Message::create(MessageType::CITY, Event(Event::Type::CITIZEN_LEFT, person)));
+    notify(Message::create(MessageType::CITY, Event(Event::Type::CITIZEN_LEFT, person)), topics(Event::Type::CITIZEN_LEFT));
 }
 
 void City::updateStatistics()
 {
     computeHappiness();
     computeAttractiveness();
+#ifdef MESSAGE_STATISTICS
+    recordGoalAllocations();
+#endif
 }
 
 void City::computeHappiness()
@@ -584,39 +699,69 @@ void City::computeAttractiveness()
     mAttractiveness *= getAverageHappiness();
 }
 
-void City::onNewMonth()
+unsigned int City::getDay() const
+{
+    unsigned int nbDaysPerMonth = static_cast<unsigned int>(NB_HOURS_PER_MONTH / 24.0f);
+    unsigned int dayInMonth = std::min(static_cast<unsigned int>(mCurrentTime / mTimePerMonth * nbDaysPerMonth), nbDaysPerMonth - 1);
+    return (mYear * 12 + mMonth) * nbDaysPerMonth + dayInMonth;
+}
+
+void City::recordGoalAllocations()
 {
-    // Update year
-    if (mMonth >= 12)
+    unsigned int day = getDay();
+    if (day != mStatisticsDay)
     {
-        mMonth = 0;
-        ++mYear;
-        onNewYear();
+        mGoalAllocations.push_back(GoalAllocations{mStatisticsDay, Goal::getNbAllocations(), Goal::getNbHeapAllocations()});
+        Goal::resetAllocationCounters();
+        mStatisticsDay = day;
     }
+}
 
-    // Update immigrants
-    updateImmigrants();
+TaskScheduler::TaskId City::addNewMonthTasks(TaskScheduler::TaskId dependency)
+{
+    TaskScheduler::TaskId date = mScheduler.addTask("new month", [this]
+    {
+        mCurrentTime -= mTimePerMonth;
+        ++mMonth;
+        mNbUpdatesInMonth = 0;
+
+        // Update year
+        if (mMonth >= 12)
+        {
+            mMonth = 0;
+            ++mYear;
+            onNewYear();
+        }
+
+        // Update immigrants
+        updateImmigrants();
+    }, {dependency});
 
     // Update markets
-    for (std::unique_ptr<MarketBase>& market : mMarkets)
-        market->sellItems();
+    TaskScheduler::TaskId sales = mScheduler.addTask("market sales", [this]
+    {
+        for (std::unique_ptr<MarketBase>& market : mMarkets)
+            market->sellItems();
+    }, {date});
 
     // Collect taxes
-    mBank.collectTaxes(mCityCompany->getAccount(), mIncomeTax, mCorporateTax);
+    TaskScheduler::TaskId taxes = mScheduler.addTask("taxes", [this]
+    {
+        mBank.collectTaxes(mCityCompany->getAccount(), mIncomeTax, mCorporateTax);
+    }, {sales});
 
-    // Send messages
-    notify(Message::create(MessageType::CITY, Event(Event::Type::NEW_MONTH, mMonth)));
-    for (Person* citizen : mCitizens)
-        mCityMessageBus.send(Message::create(citizen->getMailboxId(), MessageType::CITY, Event(Event::Type::NEW_MONTH, mMonth)));
-    mCityMessageBus.send(Message::create(mCityCompany->getMailboxId(), MessageType::CITY, Event(Event::Type::NEW_MONTH, mMonth)));
-    for (std::unique_ptr<Company>& company : mCompanies)
-        mCityMessageBus.send(Message::create(company->getMailboxId(), MessageType::CITY, Event(Event::Type::NEW_MONTH, mMonth)));
+    return mScheduler.addTask("new month messages", [this]
+    {
+        // Send messages
+        notify(Message::create(MessageType::CITY, Event(Event::Type::NEW_MONTH, mMonth)), topics(Event::Type::NEW_MONTH));
+        mChannel.publish(Message::create(MessageType::CITY, Event(Event::Type::NEW_MONTH, mMonth)));
+    }, {taxes});
 }
 
 void City::onNewYear()
 {
     // Send messages
-    notify(Message::create(MessageType::CITY, Event(Event::Type::NEW_YEAR, mYear)));
+    notify(Message::create(MessageType::CITY, Event(Event::Type::NEW_YEAR, mYear)), topics(Event::Type::NEW_YEAR));
 }
 
 void City::setUp(bool loading)
@@ -637,7 +782,7 @@ void City::setUp(bool loading)
 
     // Citizens
     for (Person* citizen : mCitizens)
-        citizen->setCity(this, &mCityMessageBus, loading);
+        citizen->setCity(this, &mCityMessageBus, &mCarPool, loading);
 
     // Companies
     mCityCompany->setCity(this, &mCityMessageBus, loading);
@@ -646,4 +791,8 @@ void City::setUp(bool loading)
 
     // Rendering
     mCarsByTile.reshape(mMap.getHeight(), mMap.getWidth());
+
+    // Statistics, the allocations of the set up are not counted
+    mStatisticsDay = getDay();
+    Goal::resetAllocationCounters();
 }
@@ -19,9 +19,12 @@
 
 #include <vector>
 #include <memory>
+#include <ostream>
 #include "util/NonCopyable.h"
 #include "util/NonMovable.h"
+#include <boost/serialization/version.hpp>
 #include "message/MessageBus.h"
+#include "message/Channel.h"
 #include "message/Subject.h"
 #include "pcg/TerrainGenerator.h"
 #include "pcg/PersonGenerator.h"
@@ -30,11 +33,15 @@
 #include "city/Map.h"
 #include "city/Bank.h"
 #include "city/Newspaper.h"
+#include "city/CarPool.h"
+#include "ai/GoalArbiter.h"
+#include "util/TaskScheduler.h"
 
 class MarketBase;
 enum class MarketType : int;
 class Building;
 class Car;
+class CitySnapshot;
 
 class City : public NonCopyable, public NonMovable, public sf::Drawable, public Subject
 {
@@ -43,6 +50,7 @@ public:
     static constexpr float MAX_NB_IMMIGRANTS_PER_MONTH = 10.0f;
     static constexpr float MAX_NB_MONTHS_WAITING = 3.0f;
     static constexpr Money SEED_MONEY = Money(30000.0);
+    static constexpr unsigned int NB_MONTH_SLICES = 16; // Number of updates over which the agents process a new month
 
     struct Intersection
     {
@@ -87,12 +95,15 @@ public:
     virtual ~City();
 
     virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void takeSnapshot(const sf::View& view, CitySnapshot& snapshot); // Copy what draw draws with this view and the info bar, the tiles of the view become the visible ones
 
     void update(float dt);
 
     // Messaging
-    void setGameMessageBus(MessageBus* messageBus);
+    void setGameMessageBus(MessageBus* messageBus); // Messages are posted as the city may be updated on another thread
     Id getMailboxId() const;
+    const Channel& getChannel() const;
+    const MessageBusStatistics& getMessageBusStatistics() const;
 
     // Name
     const std::string& getName() const;
@@ -109,8 +120,13 @@ public:
     unsigned int getYear() const;
     std::string getFormattedMonth() const;
     std::string getPrettyDate() const;
+    // When the months are staggered, each agent processes a new month in the update given by its phase
+    bool areMonthsStaggered() const;
+    void setMonthsStaggered(bool staggered);
+    bool isMonthPhaseReached(Id mailboxId) const;
 
     // Economy
+    Bank& getBank();
     const Bank& getBank() const;
     MarketBase* getMarket(MarketType type);
     const MarketBase* getMarket(MarketType type) const;
@@ -118,6 +134,15 @@ public:
     // Newspaper
     const Newspaper& getNewspaper() const;
 
+    // AI
+    bool isBatchArbitrationEnabled() const;
+    void setBatchArbitrationEnabled(bool enabled);
+
+    // Scheduling, with one thread the update is serial
+    std::size_t getNbThreads() const;
+    void setNbThreads(std::size_t nbThreads);
+    const TaskScheduler& getScheduler() const;
+
     // Company
     Company& getCompany();
     Money getFunds() const;
@@ -147,9 +172,11 @@ public:
     // Statistics
     float getAverageHappiness() const;
     float getAttractiveness() const;
+    void writeGoalAllocationsCsv(std::ostream& os) const; // One row per day, only recorded if MESSAGE_STATISTICS is defined
 
     // Util
     sf::Vector2i toTileIndices(const sf::Vector2f& position) const;
+    bool isVisible(const sf::Vector2f& position) const; // True if the tile is in the area of the last snapshot, margin included
     float getHumanTime() const;
     float getTimePerMonth() const;
     float computeNbHoursInAmonth(float nbHoursInAWeek) const;
@@ -160,6 +187,7 @@ private:
     // Messaging
     MessageBus mCityMessageBus;
     Mailbox mMailbox;
+    Channel mChannel;
 
     // Generators
     RandomGenerator mRandomGenerator;
@@ -180,6 +208,8 @@ private:
     float mTimePerMonth;
     unsigned int mMonth;
     unsigned int mYear;
+    unsigned int mNbUpdatesInMonth;
+    bool mStaggeredMonths;
 
     // Economy
     Bank mBank;
@@ -199,19 +229,42 @@ private:
     double mCorporateTax;
 
     // Agents
+    CarPool mCarPool; // Must outlive the persons
     IdManager<std::unique_ptr<Person>> mPersons;
     std::vector<Person*> mCitizens;
     std::vector<Person*> mImmigrants;
     std::vector<std::unique_ptr<Company>> mCompanies;
     IdManager<Building*> mBuildings;
     Array2<std::vector<const Car*>> mCarsByTile;
+    sf::IntRect mVisibleTiles; // Tiles of the last snapshot, x is the column and y is the row
+
+    // AI
+    GoalArbiter mGoalArbiter;
+    bool mBatchArbitration;
 
     // Immigration
     std::vector<unsigned int> mTimeBeforeLeaving;
 
     // Statistics
+    struct GoalAllocations
+    {
+        unsigned int day;
+        unsigned long long nbAllocations;
+        unsigned long long nbHeapAllocations;
+    };
+
     float mHappiness;
     float mAttractiveness;
+    unsigned int mStatisticsDay; // Day whose goal allocations are being counted
+    std::vector<GoalAllocations> mGoalAllocations;
+
+    // Update
+    TaskScheduler mScheduler;
+
+    void readMessages();
+    void updateCarsByTile();
+    void sortCarsByTile(std::size_t firstRow, std::size_t lastRow);
+    sf::IntRect computeVisibleTiles(const sf::View& view) const; // Tiles in the view with a margin
 
     void updateImmigrants();
     void generateImmigrant();
@@ -221,9 +274,11 @@ private:
     void updateStatistics();
     void computeHappiness();
     void computeAttractiveness();
+    unsigned int getDay() const; // Number of days since the creation of the city
+    void recordGoalAllocations();
 
     // Events
-    void onNewMonth();
+    TaskScheduler::TaskId addNewMonthTasks(TaskScheduler::TaskId dependency); // Returns the last task
     void onNewYear();
 
     // Set up
@@ -247,10 +302,11 @@ private:
         ar & mTimeBeforeLeaving;
         ar & mHappiness & mAttractiveness;
         ar & mCityMessageBus;
+        ar & mChannel;
     }
 
     template<typename Archive>
-    void load(Archive& ar, const unsigned int /*version*/)
+    void load(Archive& ar, const unsigned int version)
     {
         ar & mMailbox;
         ar & mName;
@@ -264,9 +320,12 @@ private:
         ar & mTimeBeforeLeaving;
         ar & mHappiness & mAttractiveness;
         ar & mCityMessageBus;
+        if (version >= 1)
+            ar & mChannel;
         setUp(true);
     }
 
     BOOST_SERIALIZATION_SPLIT_MEMBER()
 };
 
+BOOST_CLASS_VERSION(City, 1)
@@ -0,0 +1,70 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "city/CitySnapshot.h"
+#include <utility>
+#include <SFML/Graphics/RenderTarget.hpp>
+
+CitySnapshot::CitySnapshot() : mFunds(0.0), mPopulation(0), mHappiness(0.0f)
+{
+
+}
+
+void CitySnapshot::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    for (const sf::Sprite& sprite : mSprites)
+        target.draw(sprite, states);
+}
+
+void CitySnapshot::clear()
+{
+    mSprites.clear();
+}
+
+void CitySnapshot::addSprite(const sf::Sprite& sprite)
+{
+    mSprites.push_back(sprite);
+}
+
+void CitySnapshot::setInfo(std::string date, Money funds, unsigned int population, float happiness)
+{
+    mDate = std::move(date);
+    mFunds = funds;
+    mPopulation = population;
+    mHappiness = happiness;
+}
+
+const std::string& CitySnapshot::getDate() const
+{
+    return mDate;
+}
+
+Money CitySnapshot::getFunds() const
+{
+    return mFunds;
+}
+
+unsigned int CitySnapshot::getPopulation() const
+{
+    return mPopulation;
+}
+
+float CitySnapshot::getAverageHappiness() const
+{
+    return mHappiness;
+}
@@ -0,0 +1,52 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include "city/Money.h"
+#include "city/SpriteList.h"
+
+// Immutable copy of what the city draws in an area and of the info bar, it can be read while the city is updated
+class CitySnapshot : public sf::Drawable, public SpriteList
+{
+public:
+    CitySnapshot();
+
+    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    void clear(); // Keep the memory to fill it again
+    virtual void addSprite(const sf::Sprite& sprite) override;
+
+    // Info bar
+    void setInfo(std::string date, Money funds, unsigned int population, float happiness);
+    const std::string& getDate() const;
+    Money getFunds() const;
+    unsigned int getPopulation() const;
+    float getAverageHappiness() const;
+
+private:
+    std::vector<sf::Sprite> mSprites; // Tiles and cars in the order they are drawn
+    std::string mDate;
+    Money mFunds;
+    unsigned int mPopulation;
+    float mHappiness;
+};
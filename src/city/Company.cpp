@@ -52,7 +52,7 @@ const std::vector<std::unique_ptr<Work>>* Company::getEmployees(const Building*
 
 Company::Company(std::string name, int creationYear, Person* owner, Money funds) :
     mName(std::move(name)), mCreationYear(creationYear),
-    mCity(nullptr), mMessageBus(nullptr), mOwner(owner), mFunds(funds), mAccount(UNDEFINED)
+    mCity(nullptr), mMessageBus(nullptr), mOwner(owner), mChannelCursor(0), mNewMonthPending(false), mFunds(funds), mAccount(UNDEFINED)
 {
     mRents.fill(Money(0.0));
     mSalaries.fill(Money(0.0));
@@ -60,6 +60,13 @@ Company::Company(std::string name, int creationYear, Person* owner, Money funds)
     mRetailMargins.fill(0.0);
 }
 
+Company::Company() :
+    mCreationYear(0), mCity(nullptr), mMessageBus(nullptr), mOwner(nullptr),
+    mChannelCursor(0), mNewMonthPending(false), mAccount(UNDEFINED)
+{
+
+}
+
 Company::~Company()
 {
     // Close bank account
@@ -73,16 +80,15 @@ Company::~Company()
 void Company::update(float /*dt*/)
 {
      // Messages
-    while (!mMailbox.isEmpty())
+    mMailbox.drain([&](Message& message)
     {
-        Message message = mMailbox.get();
         if (message.type == MessageType::CITY)
         {
             const City::Event& event = message.getInfo<City::Event>();
             switch (event.type)
             {
                 case City::Event::Type::NEW_MONTH:
-                    onNewMonth();
+                    receiveNewMonth();
                     break;
                 case City::Event::Type::NEW_MINIMUM_WAGE:
                     onNewMinimumWage(event.minimumWage);
@@ -120,7 +126,33 @@ void Company::update(float /*dt*/)
                     break;
             }
         }
-    }
+    });
+
+    // Broadcast messages
+    mCity->getChannel().read(mChannelCursor, [&](const Message& message)
+    {
+        const City::Event& event = message.getInfo<City::Event>();
+        switch (event.type)
+        {
+            case City::Event::Type::NEW_MONTH:
+                receiveNewMonth();
+                break;
+            case City::Event::Type::NEW_MINIMUM_WAGE:
+                onNewMinimumWage(event.minimumWage);
+                break;
+            default:
+                break;
+        }
+    }, [&](std::size_t /*nbMissed*/)
+    {
+        // Catch up with the current state of the city as the missed messages are unknown
+        receiveNewMonth();
+        onNewMinimumWage(mCity->getMinimumWage());
+    });
+
+    // Process the new month in the update given by the phase of the company
+    if (mNewMonthPending && mCity->isMonthPhaseReached(mMailbox.getId()))
+        onNewMonth();
 
     // Update buildings
     for (Building* building : mBuildings)
@@ -144,6 +176,7 @@ void Company::setCity(const City* city, MessageBus* messageBus, bool alreadyAdde
     if (!alreadyAdded)
     {
         mMessageBus->addMailbox(mMailbox);
+        mChannelCursor = mCity->getChannel().getCursor();
         // Create bank account
         mMessageBus->send(Message::create(mMailbox.getId(), mCity->getBank().getMailboxId(), MessageType::BANK, mCity->getBank().createCreateAccountEvent(Bank::Account::Type::COMPANY, mFunds)));
     }
@@ -227,16 +260,18 @@ void Company::removeBuilding(Building* building)
     // Alert the employees
     else
     {
+        std::vector<Bank::Posting> salaries;
         for (std::unique_ptr<Work>& work : *getEmployees(building))
         {
             if (work->getEmployee())
             {
                 // Pay the employee if necessary
                 if (work->hasWorkedThisMonth())
-                    mMessageBus->send(Message::create(mMailbox.getId(), mCity->getBank().getMailboxId(), MessageType::BANK, mCity->getBank().createTransferMoneyEvent(mAccount, work->getEmployee()->getAccount(), work->getSalary())));
+                    salaries.push_back(Bank::Posting{work->getEmployee()->getAccount(), work->getSalary()});
                 mMessageBus->send(Message::create(work->getEmployee()->getMailboxId(), MessageType::PERSON, Person::Event{Person::Event::Type::FIRED}));
             }
         }
+        paySalaries(std::move(salaries));
     }
     // Tear down the building
     building->tearDown();
@@ -315,8 +350,19 @@ void Company::addToMarket(Work* work)
     mMessageBus->send(Message::create(work->getWorkplace()->getMailboxId(), market->getMailboxId(), MessageType::MARKET, market->createAddItemEvent(mAccount, work, work->getSalary())));
 }
 
+void Company::receiveNewMonth()
+{
+    // A month still pending is processed before the next one
+    if (mNewMonthPending)
+        onNewMonth();
+    mNewMonthPending = true;
+    if (mCity->isMonthPhaseReached(mMailbox.getId()))
+        onNewMonth();
+}
+
 void Company::onNewMonth()
 {
+    mNewMonthPending = false;
     // Update buildings
     for (Building* building : mBuildings)
     {
@@ -327,6 +373,7 @@ void Company::onNewMonth()
     }
 
     // Pay salaries
+    std::vector<Bank::Posting> salaries;
     for (Building* building : mBuildings)
     {
         if (!building->isHousing())
@@ -334,11 +381,19 @@ void Company::onNewMonth()
             for (std::unique_ptr<Work>& work : *getEmployees(building))
             {
                 if (work->hasWorkedThisMonth())
-                    mMessageBus->send(Message::create(mMailbox.getId(), mCity->getBank().getMailboxId(), MessageType::BANK, mCity->getBank().createTransferMoneyEvent(mAccount, work->getEmployee()->getAccount(), work->getSalary())));
+                    salaries.push_back(Bank::Posting{work->getEmployee()->getAccount(), work->getSalary()});
                 work->setWorkedThisMonth(false);
             }
         }
     }
+    paySalaries(std::move(salaries));
+}
+
+void Company::paySalaries(std::vector<Bank::Posting> salaries)
+{
+    // One message for all the salaries instead of one per employee
+    if (!salaries.empty())
+        mMessageBus->send(Message::create(mMailbox.getId(), mCity->getBank().getMailboxId(), MessageType::BANK, mCity->getBank().createTransferMoneyBatchEvent(mAccount, std::move(salaries))));
 }
 
 void Company::onNewMinimumWage(Money minimumWage)
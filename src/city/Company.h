@@ -21,7 +21,10 @@
 #include <string>
 #include "util/NonCopyable.h"
 #include "util/NonMovable.h"
+#include <boost/serialization/version.hpp>
 #include "message/Mailbox.h"
+#include "message/Channel.h"
+#include "city/Bank.h"
 #include "city/Tile.h"
 #include "city/Money.h"
 
@@ -79,6 +82,8 @@ private:
     MessageBus* mMessageBus;
     const Person* mOwner;
     Mailbox mMailbox;
+    Channel::Cursor mChannelCursor;
+    bool mNewMonthPending;
 
     // Finance
     Money mFunds;
@@ -97,19 +102,29 @@ private:
     void addToMarket(Work* work);
 
     // Events
+    void receiveNewMonth();
     void onNewMonth();
     void onNewMinimumWage(Money minimumWage);
+    void paySalaries(std::vector<Bank::Posting> salaries);
 
     // Serialization
     friend class boost::serialization::access;
 
-    Company() = default;
+    Company();
 
     template<typename Archive>
-    void serialize(Archive& ar, const unsigned int /*version*/)
+    void serialize(Archive& ar, const unsigned int version)
     {
         ar & mName & mCreationYear & mOwner & mMailbox & mAccount;
+        if (version >= 1)
+            ar & mChannelCursor;
+        if (version >= 2)
+            ar & mNewMonthPending;
+        else
+            mNewMonthPending = false;
         ar & mBuildings;
         ar & mRents & mSalaries & mWholesaleMargins & mRetailMargins;
     }
 };
+
+BOOST_CLASS_VERSION(Company, 2)
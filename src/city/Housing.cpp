@@ -36,9 +36,8 @@ std::unique_ptr<Tile> Housing::clone() const
 void Housing::update()
 {
     // Read messages
-    while (!mMailbox.isEmpty())
+    mMailbox.drain([&](Message& message)
     {
-        Message message = mMailbox.get();
         if (message.type == MessageType::MARKET)
         {
             const Market<Lease>::Event& event = message.getInfo<const Market<Lease>::Event>();
@@ -54,7 +53,7 @@ void Housing::update()
                     break;
             }
         }
-    }
+    });
 }
 
 void Housing::tearDown()
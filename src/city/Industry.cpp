@@ -41,9 +41,8 @@ std::unique_ptr<Tile> Industry::clone() const
 void Industry::update()
 {
     // Read messages
-    while (!mMailbox.isEmpty())
+    mMailbox.drain([&](Message& message)
     {
-        Message message = mMailbox.get();
         if (message.type == MessageType::MARKET)
         {
             const MarketBase::EventBase& eventBase = message.getInfo<MarketBase::EventBase>();
@@ -78,7 +77,7 @@ void Industry::update()
                 }
             }
         }
-    }
+    });
 }
 
 void Industry::tearDown()
@@ -181,9 +180,10 @@ void Industry::sellGoods()
             {
                 Money costPerUnit = mStock[1].getCostPerUnit();
                 mStock[1].quantity -= needQuantity;
-                mStock[1].cost -= needQuantity * costPerUnit;
+                Money cost(needQuantity * costPerUnit);
+                mStock[1].cost -= cost;
                 mStock.front().quantity = 1.0;
-                mStock.front().cost += needQuantity * costPerUnit;
+                mStock.front().cost += cost;
             }
             else
             {
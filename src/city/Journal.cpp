@@ -0,0 +1,124 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "city/Journal.h"
+#include <algorithm>
+#include <fstream>
+#include "util/debug.h"
+
+constexpr std::size_t Journal::BLOCK_SIZE;
+constexpr std::uint64_t Journal::ALL_RECORDS;
+
+Journal::Journal() : mTick(0), mSize(0), mNbSpilledRecords(0)
+{
+
+}
+
+void Journal::tick()
+{
+    ++mTick;
+}
+
+unsigned int Journal::getTick() const
+{
+    return mTick;
+}
+
+std::size_t Journal::getNbRecords() const
+{
+    return mSize;
+}
+
+const Journal::Record& Journal::getRecord(std::size_t i) const
+{
+    return mBlocks[i / BLOCK_SIZE][i % BLOCK_SIZE];
+}
+
+bool Journal::spill(const std::string& path)
+{
+    // A file left by another city or by a save that did not complete has records that are not ours
+    mNbSpilledRecords = keepRecords(path, mNbSpilledRecords);
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::app);
+    if (!file)
+    {
+        DEBUG("Fail to open the journal " << path << "\n");
+        return false;
+    }
+    for (std::size_t i = 0; i < mSize; i += BLOCK_SIZE)
+    {
+        std::size_t nbRecords = std::min(mSize - i, BLOCK_SIZE);
+        file.write(reinterpret_cast<const char*>(mBlocks[i / BLOCK_SIZE].get()), nbRecords * sizeof(Record));
+    }
+    if (!file)
+    {
+        DEBUG("Fail to write the journal " << path << "\n");
+        return false;
+    }
+    mNbSpilledRecords += mSize;
+    // Keep the first block to avoid allocating again
+    if (!mBlocks.empty())
+        mBlocks.resize(1);
+    mSize = 0;
+    return true;
+}
+
+std::uint64_t Journal::keepRecords(const std::string& path, std::uint64_t nbRecords)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+    std::uint64_t nbRecordsInFile = file ? static_cast<std::uint64_t>(file.tellg()) / sizeof(Record) : 0;
+    DEBUG_IF(nbRecords != ALL_RECORDS && nbRecordsInFile < nbRecords, "The journal " << path << " misses " << (nbRecords - nbRecordsInFile) << " records\n");
+    if (nbRecords == ALL_RECORDS || nbRecordsInFile == nbRecords)
+        return nbRecordsInFile;
+    nbRecords = std::min(nbRecords, nbRecordsInFile);
+    // Rewrite the records to keep, it only happens when the file does not match the save
+    std::vector<char> records(nbRecords * sizeof(Record));
+    file.seekg(0);
+    file.read(records.data(), records.size());
+    file.close();
+    std::ofstream output(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    output.write(records.data(), records.size());
+    return nbRecords;
+}
+
+bool Journal::replay(const std::string& path, std::vector<Money>& balances, std::size_t& nbRecords)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file)
+    {
+        DEBUG("Fail to open the journal " << path << "\n");
+        return false;
+    }
+    nbRecords = 0;
+    Record record;
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(Record)))
+    {
+        // The balances are indexed by the slots of the accounts, a closed account has a null balance before its slot is reused
+        std::size_t issuer = record.issuer != UNDEFINED ? getIdSlot(record.issuer) : 0;
+        std::size_t receiver = record.receiver != UNDEFINED ? getIdSlot(record.receiver) : 0;
+        if (std::max(issuer, receiver) >= balances.size())
+            balances.resize(std::max(issuer, receiver) + 1, Money(0.0));
+        if (record.issuer != UNDEFINED)
+            balances[issuer] -= record.amount;
+        if (record.receiver != UNDEFINED)
+            balances[receiver] += record.amount;
+        ++nbRecords;
+    }
+    // A partial record means that the file is truncated
+    DEBUG_IF(file.gcount() != 0, "The journal " << path << " is truncated\n");
+    return file.gcount() == 0;
+}
@@ -0,0 +1,101 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/version.hpp>
+#include "util/Id.h"
+#include "util/NonCopyable.h"
+#include "city/Money.h"
+
+// Append-only log of the money moved by the bank
+class Journal : public NonCopyable
+{
+public:
+    enum class Reason : std::uint32_t{OPEN_ACCOUNT, CLOSE_ACCOUNT, TRANSFER, BATCH_TRANSFER, TAX};
+
+    // The money goes from nowhere if issuer is UNDEFINED and to nowhere if receiver is UNDEFINED
+    struct Record
+    {
+        std::uint32_t tick;
+        Reason reason;
+        Id issuer;
+        Id receiver;
+        Money amount;
+    };
+
+    static_assert(std::is_trivially_copyable<Record>::value, "Records are written as is in the files.");
+
+    Journal();
+
+    void tick();
+    unsigned int getTick() const;
+
+    void add(Id issuer, Id receiver, Money amount, Reason reason)
+    {
+        if (mSize == mBlocks.size() * BLOCK_SIZE)
+            mBlocks.emplace_back(new Record[BLOCK_SIZE]);
+        mBlocks[mSize / BLOCK_SIZE][mSize % BLOCK_SIZE] = Record{mTick, reason, issuer, receiver, amount};
+        ++mSize;
+    }
+
+    std::size_t getNbRecords() const;
+    const Record& getRecord(std::size_t i) const;
+
+    // Append the records to the file and remove them from memory
+    // The records of the file that were not spilled by this journal are removed first
+    bool spill(const std::string& path);
+
+    // Apply the records of a file to the balances, indexed by the slots of the account ids
+    static bool replay(const std::string& path, std::vector<Money>& balances, std::size_t& nbRecords);
+
+private:
+    static constexpr std::size_t BLOCK_SIZE = 4096;
+    static constexpr std::uint64_t ALL_RECORDS = ~std::uint64_t(0);
+
+    unsigned int mTick;
+    std::vector<std::unique_ptr<Record[]>> mBlocks;
+    std::size_t mSize;
+    std::uint64_t mNbSpilledRecords; // ALL_RECORDS if unknown, then the file is trusted
+
+    // Truncate the file to its first nbRecords records, return the number of records kept
+    static std::uint64_t keepRecords(const std::string& path, std::uint64_t nbRecords);
+
+    // Serialization
+    friend class boost::serialization::access;
+
+    // Only the tick and the number of records in the file are saved, the records are in the journal file
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int version)
+    {
+        ar & mTick;
+        if (version >= 1)
+            ar & mNbSpilledRecords;
+        else
+            mNbSpilledRecords = ALL_RECORDS;
+    }
+};
+
+// Version 1: number of records in the file
+BOOST_CLASS_VERSION(Journal, 1)
@@ -16,6 +16,11 @@
  */
 
 #include "city/Market.h"
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+constexpr std::size_t MarketBase::NB_STATISTICS; // Could be removed in C++17
 
 MarketBase::EventBase::EventBase()
 {
@@ -49,3 +54,63 @@ Id MarketBase::getMailboxId() const
 {
     return mMailbox.getId();
 }
+
+const RingBuffer<MarketBase::Statistics, MarketBase::NB_STATISTICS>& MarketBase::getStatistics() const
+{
+    return mStatistics;
+}
+
+void MarketBase::writeStatisticsCsv(std::ostream& os) const
+{
+    os << "items,bids,sold,min_price,median_price,max_price,clearing_time_us\n";
+    for (std::size_t i = 0; i < mStatistics.getSize(); ++i)
+    {
+        const Statistics& statistics = mStatistics[i];
+        os << statistics.nbItems << ',' << statistics.nbBids << ',' << statistics.nbSoldItems << ',' <<
+            statistics.minPrice << ',' << statistics.medianPrice << ',' << statistics.maxPrice << ',' <<
+            statistics.clearingTime << '\n';
+    }
+}
+
+void MarketBase::writeStatisticsBinary(std::ostream& os) const
+{
+    // Fixed-size little-endian records preceded by the market type and the number of records
+    auto write = [&os](auto x)
+    {
+        static_assert(sizeof(x) == 4 || sizeof(x) == 8, "Only 32-bit and 64-bit values are written");
+        // Write the bits from the least significant byte whatever the byte order of the host
+        std::conditional_t<sizeof(x) == 8, uint64_t, uint32_t> bits;
+        std::memcpy(&bits, &x, sizeof(x));
+        for (std::size_t i = 0; i < sizeof(x); ++i)
+            os.put(static_cast<char>((bits >> (8 * i)) & 0xff));
+    };
+    write(static_cast<int32_t>(mType));
+    write(static_cast<uint32_t>(mStatistics.getSize()));
+    for (std::size_t i = 0; i < mStatistics.getSize(); ++i)
+    {
+        const Statistics& statistics = mStatistics[i];
+        write(static_cast<uint32_t>(statistics.nbItems));
+        write(static_cast<uint32_t>(statistics.nbBids));
+        write(static_cast<uint32_t>(statistics.nbSoldItems));
+        write(static_cast<double>(statistics.minPrice));
+        write(static_cast<double>(statistics.medianPrice));
+        write(static_cast<double>(statistics.maxPrice));
+        write(statistics.clearingTime);
+    }
+}
+
+void MarketBase::recordStatistics(unsigned int nbItems, unsigned int nbBids, std::chrono::steady_clock::duration clearingTime)
+{
+    Statistics statistics{nbItems, nbBids, static_cast<unsigned int>(mSoldPrices.size()), Money(0.0), Money(0.0), Money(0.0),
+        std::chrono::duration<float, std::micro>(clearingTime).count()};
+    if (!mSoldPrices.empty())
+    {
+        auto median = mSoldPrices.begin() + mSoldPrices.size() / 2;
+        std::nth_element(mSoldPrices.begin(), median, mSoldPrices.end());
+        statistics.medianPrice = *median;
+        auto bounds = std::minmax_element(mSoldPrices.begin(), mSoldPrices.end());
+        statistics.minPrice = *bounds.first;
+        statistics.maxPrice = *bounds.second;
+    }
+    mStatistics.push(statistics);
+}
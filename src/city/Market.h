@@ -19,11 +19,14 @@
 
 #include <unordered_map>
 #include <algorithm>
+#include <chrono>
+#include <ostream>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/split_member.hpp>
 #include "util/NonCopyable.h"
 #include "util/NonMovable.h"
 #include "util/IdManager.h"
+#include "util/RingBuffer.h"
 #include "util/debug.h"
 #include "message/MessageBus.h"
 #include "message/Subject.h"
@@ -63,6 +66,19 @@ public:
         }
     };
 
+    struct Statistics
+    {
+        unsigned int nbItems;
+        unsigned int nbBids;
+        unsigned int nbSoldItems;
+        Money minPrice;
+        Money medianPrice;
+        Money maxPrice;
+        float clearingTime; // In microseconds
+    };
+
+    static constexpr std::size_t NB_STATISTICS = 120; // Ten years of sales
+
     MarketBase(MarketType type);
     virtual ~MarketBase();
 
@@ -73,11 +89,20 @@ public:
 
     Id getMailboxId() const;
 
+    // Statistics
+    const RingBuffer<Statistics, NB_STATISTICS>& getStatistics() const;
+    void writeStatisticsCsv(std::ostream& os) const;
+    void writeStatisticsBinary(std::ostream& os) const;
+
 protected:
     MessageBus* mMessageBus;
     Mailbox mMailbox;
     unsigned int mTime;
     MarketType mType;
+    RingBuffer<Statistics, NB_STATISTICS> mStatistics;
+    std::vector<Money> mSoldPrices; // Only used to compute the median, kept to reuse its memory
+
+    void recordStatistics(unsigned int nbItems, unsigned int nbBids, std::chrono::steady_clock::duration clearingTime);
 
     MarketBase() = default; // Only for serialization
 
@@ -230,7 +255,7 @@ public:
 
     Market(MarketType type) : MarketBase(type), mDirty(false)
     {
-
+        setUpCoalescing();
     }
 
     Id addItem(Id sellerId, Id sellerAccount, T* good, Money reservePrice)
@@ -243,7 +268,7 @@ public:
         // Notify
         Event event = createItemAddedEvent(id);
         mMessageBus->send(Message::create(sellerId, MessageType::MARKET, event));
-        notify(Message::create(MessageType::MARKET, event));
+        notify(Message::create(MessageType::MARKET, event), topics(Event::Type::ITEM_ADDED));
         return id;
     }
 
@@ -253,7 +278,7 @@ public:
         mAuctions.erase(itemId);
         mDirty = true;
         // Notify
-        notify(Message::create(MessageType::MARKET, createItemRemovedEvent(itemId)));
+        notify(Message::create(MessageType::MARKET, createItemRemovedEvent(itemId)), topics(Event::Type::ITEM_REMOVED));
     }
 
     const Item& getItem(Id itemId) const
@@ -292,9 +317,8 @@ public:
 
     virtual void update() override
     {
-        while (!mMailbox.isEmpty())
+        mMailbox.drain([&](Message& message)
         {
-            Message message = mMailbox.get();
             if (message.type == MessageType::MARKET)
             {
                 const Event& event = message.getInfo<Event>();
@@ -336,19 +360,26 @@ public:
                         break;
                 }
             }
-        }
+        });
     }
 
     virtual void sellItems() override
     {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
         // Sort auctions by timestamp
         std::vector<Auction*> auctions;
+        unsigned int nbBids = 0;
         for (Auction& auction : mAuctions.getObjects())
+        {
             auctions.push_back(&auction);
+            nbBids += auction.bids.size();
+        }
         std::sort(auctions.begin(), auctions.end(), [&](Auction* lhs, Auction* rhs) { return lhs->timestamp < rhs->timestamp; });
 
         // Sell the goods
         std::vector<Id> soldItems;
+        mSoldPrices.clear();
         for (Auction* auction : auctions)
         {
             if (!auction->bids.empty())
@@ -361,6 +392,7 @@ public:
                     mMessageBus->send(Message::create(item.sellerId, MessageType::MARKET, createSaleEvent(item, bid.value)));
                     --mDesiredQuantities[bid.bidderId];
                     soldItems.push_back(item.id);
+                    mSoldPrices.push_back(bid.value);
                 }
             }
         }
@@ -370,7 +402,7 @@ public:
         {
             mAuctions.erase(id);
             // Notify
-            notify(Message::create(MessageType::MARKET, createItemRemovedEvent(id)));
+            notify(Message::create(MessageType::MARKET, createItemRemovedEvent(id)), topics(Event::Type::ITEM_REMOVED));
         }
         if (!soldItems.empty())
             mDirty = true;
@@ -379,6 +411,9 @@ public:
         for (Auction& auction : mAuctions.getObjects())
             auction.bids.clear();
         mDesiredQuantities.clear();
+
+        // Statistics
+        recordStatistics(auctions.size(), nbBids, std::chrono::steady_clock::now() - start);
     }
 
     Event createAddItemEvent(Id sellerAccount, T* good, Money reservePrice) const
@@ -446,7 +481,16 @@ private:
     // Serialization
     friend class boost::serialization::access;
 
-    Market() = default;
+    Market()
+    {
+        setUpCoalescing();
+    }
+
+    void setUpCoalescing()
+    {
+        // Only the last desired quantity of each bidder matters
+        mMailbox.coalesce(MessageType::MARKET, static_cast<unsigned char>(Event::Type::SET_QUANTITY));
+    }
 
     template<typename Archive>
     void save(Archive& ar, const unsigned int /*version*/) const
@@ -17,12 +17,156 @@
  
 #pragma once
 
+#include <cstdint>
+#include <boost/serialization/split_free.hpp>
+#include <boost/serialization/version.hpp>
 #include "util/strong_typedef.h"
 
+//#define FIXED_POINT_MONEY // Uncomment to store money as an integer number of ten-thousandths
+
+#ifdef FIXED_POINT_MONEY
+
+// Same interface as the double version but sums of Money are exact so they do not depend on the order
+class Money
+{
+public:
+    static constexpr std::int64_t SCALE = 10000;
+
+    Money()
+    {
+
+    }
+
+    constexpr explicit Money(double t) : mT(static_cast<std::int64_t>(t * SCALE + (t < 0.0 ? -0.5 : 0.5)))
+    {
+
+    }
+
+    constexpr Money& operator=(double t)
+    {
+        *this = Money(t);
+        return *this;
+    }
+
+    constexpr operator double() const
+    {
+        return static_cast<double>(mT) / SCALE;
+    }
+
+    constexpr Money& operator+=(Money m)
+    {
+        mT += m.mT;
+        return *this;
+    }
+
+    constexpr Money& operator-=(Money m)
+    {
+        mT -= m.mT;
+        return *this;
+    }
+
+    friend constexpr Money operator+(Money a, Money b)
+    {
+        return a += b;
+    }
+
+    friend constexpr Money operator-(Money a, Money b)
+    {
+        return a -= b;
+    }
+
+    friend constexpr Money operator-(Money a)
+    {
+        return Money(0.0) -= a;
+    }
+
+    friend constexpr bool operator==(Money a, Money b)
+    {
+        return a.mT == b.mT;
+    }
+
+    friend constexpr bool operator!=(Money a, Money b)
+    {
+        return a.mT != b.mT;
+    }
+
+    friend constexpr bool operator<(Money a, Money b)
+    {
+        return a.mT < b.mT;
+    }
+
+    friend constexpr bool operator>(Money a, Money b)
+    {
+        return a.mT > b.mT;
+    }
+
+    friend constexpr bool operator<=(Money a, Money b)
+    {
+        return a.mT <= b.mT;
+    }
+
+    friend constexpr bool operator>=(Money a, Money b)
+    {
+        return a.mT >= b.mT;
+    }
+
+    std::int64_t getRaw() const
+    {
+        return mT;
+    }
+
+    void setRaw(std::int64_t t)
+    {
+        mT = t;
+    }
+
+private:
+    std::int64_t mT;
+};
+
+#else
+
 STRONG_TYPEDEF(double, Money)
 
+#endif
+
+// Version 0: double
+// Version 1: integer number of ten-thousandths
+// Both versions can be loaded by both builds
+#ifdef FIXED_POINT_MONEY
+BOOST_CLASS_VERSION(Money, 1)
+#endif
+
+BOOST_SERIALIZATION_SPLIT_FREE(Money)
+
+template<typename Archive>
+void save(Archive& ar, const Money& money, const unsigned int /*version*/)
+{
+#ifdef FIXED_POINT_MONEY
+    std::int64_t t = money.getRaw();
+#else
+    double t = money;
+#endif
+    ar & t;
+}
+
 template<typename Archive>
-void serialize(Archive& ar, Money &money, const unsigned int /*version*/)
+void load(Archive& ar, Money& money, const unsigned int version)
 {
-    ar & static_cast<double&>(money);
+    if (version >= 1)
+    {
+        std::int64_t t;
+        ar & t;
+#ifdef FIXED_POINT_MONEY
+        money.setRaw(t);
+#else
+        money = static_cast<double>(t) / 10000;
+#endif
+    }
+    else
+    {
+        double t;
+        ar & t;
+        money = t;
+    }
 }
@@ -30,9 +30,8 @@ void Newspaper::update()
 {
     Edition edition;
     edition.date = mCity->getPrettyDate();
-    while (!mMailbox.isEmpty())
+    mMailbox.drain([&](Message& message)
     {
-        Message message = mMailbox.get();
         if (message.type == MessageType::CITY)
         {
             const City::Event& event = message.getInfo<City::Event>();
@@ -47,7 +46,7 @@ void Newspaper::update()
             }
         }
 
-    }
+    });
     mEditions.emplace_back(std::move(edition));
 }
 
@@ -16,6 +16,7 @@
  */
 
 #include "city/Person.h"
+#include "city/CarPool.h"
 #include "city/Business.h"
 #include "city/Lease.h"
 #include "city/City.h"
@@ -23,13 +24,8 @@
 #include "city/Work.h"
 #include "city/Good.h"
 #include "message/MessageBus.h"
-#include "ai/GoalRestEvaluator.h"
-#include "ai/GoalWorkEvaluator.h"
-#include "ai/GoalShopEvaluator.h"
-#include "ai/GoalEnterCityEvaluator.h"
-#include "ai/GoalLeaveCityEvaluator.h"
-#include "ai/GoalGetBetterHomeEvaluator.h"
-#include "ai/GoalGetBetterWorkEvaluator.h"
+
+constexpr float Person::NO_TIME;
 
 Person::Event::Event()
 {
@@ -51,31 +47,35 @@ Person::Event::Event(Type type, Work* work) : type(type), work(work)
 
 }
 
-Person::Person(const std::string& firstName, const std::string& lastName, Gender gender, int birth,
-        const std::string& car, const std::array<float, static_cast<int>(Need::COUNT)>& decayRates,
+Person::Person(std::uint32_t firstName, std::uint32_t lastName, Gender gender, int birth,
+        std::uint32_t car, const std::array<float, static_cast<int>(Need::COUNT)>& decayRates,
         double productivity, const std::array<float, NB_EVALUATORS>& biases, Money funds) :
-    mId(UNDEFINED), mFirstName(firstName), mLastName(lastName), mGender(gender), mBirth(birth),
-    mCity(nullptr), mMessageBus(nullptr),
-    mState(State::INVISIBLE), mHome(nullptr), mWork(nullptr), mConsumptionHabit(GoodType::NECESSARY), mCar(car),
-    mFunds(funds), mAccount(UNDEFINED), mLastMonthBalance(0.0), mMonthBalance(0.0),
+    mId(UNDEFINED), mProfile(new Profile{firstName, lastName, gender, birth, funds, Qualification::NON_QUALIFIED, car}),
+    mCity(nullptr), mMessageBus(nullptr), mCarPool(nullptr), mChannelCursor(0), mNewMonthPending(false),
+    mState(State::INVISIBLE), mHome(nullptr), mWork(nullptr), mConsumptionHabit(GoodType::NECESSARY), mCar(nullptr),
+    mAccount(UNDEFINED), mLastMonthBalance(0.0), mMonthBalance(0.0),
     mDecayRates(decayRates), mNeeds{1.0f, 1.0f, 1.0f, 1.0f, 1.0f}, mAverageNeeds{0.0f, 0.0f, 0.0f, 0.0f, 0.0f},
-    mProductivity(productivity), mQualification(Qualification::NON_QUALIFIED),
-    mShortTermBrain(this), mLongTermBrain(this)
+    mNeedTimes{NO_TIME, NO_TIME, NO_TIME, NO_TIME, NO_TIME},
+    mProductivity(productivity),
+    mBiases{biases[0], biases[1], biases[2], 1.0f, biases[3], biases[4], biases[5]},
+    mShortTermBrain(this, GoalEvaluator::Type::REST, GoalEvaluator::Type::ENTER_CITY),
+    mLongTermBrain(this, GoalEvaluator::Type::ENTER_CITY, GoalEvaluator::Type::COUNT)
+{
+
+}
+
+Person::Person() :
+    mProfile(std::make_unique<Profile>()), mCity(nullptr), mMessageBus(nullptr), mCarPool(nullptr),
+    mChannelCursor(0), mNewMonthPending(false), mCar(nullptr)
 {
-    mCar.setDriver(this);
 
-    // Add evaluators to the brains
-    mShortTermBrain.addEvaluator(std::make_unique<GoalRestEvaluator>(biases[0]));
-    mShortTermBrain.addEvaluator(std::make_unique<GoalWorkEvaluator>(biases[1]));
-    mShortTermBrain.addEvaluator(std::make_unique<GoalShopEvaluator>(biases[2]));
-    mLongTermBrain.addEvaluator(std::make_unique<GoalEnterCityEvaluator>(1.0f));
-    mLongTermBrain.addEvaluator(std::make_unique<GoalLeaveCityEvaluator>(biases[3]));
-    mLongTermBrain.addEvaluator(std::make_unique<GoalGetBetterHomeEvaluator>(biases[4]));
-    mLongTermBrain.addEvaluator(std::make_unique<GoalGetBetterWorkEvaluator>(biases[5]));
 }
 
 Person::~Person()
 {
+    // Return the car
+    if (mCar)
+        mCarPool->checkIn(mCar);
     // Close bank account
     if (mAccount != UNDEFINED)
         mMessageBus->send(Message::create(mMailbox.getId(), mCity->getBank().getMailboxId(), MessageType::BANK, mCity->getBank().createCloseAccountEvent(mAccount)));
@@ -84,12 +84,11 @@ Person::~Person()
         mMessageBus->removeMailbox(mMailbox);
 }
 
-void Person::update(float dt)
+void Person::update(float /*dt*/)
 {
     // Messages
-    while (!mMailbox.isEmpty())
+    mMailbox.drain([&](Message& message)
     {
-        Message message = mMailbox.get();
         mShortTermBrain.handle(message);
         mLongTermBrain.handle(message);
         if (message.type == MessageType::CITY)
@@ -98,7 +97,7 @@ void Person::update(float dt)
             switch (event.type)
             {
                 case City::Event::Type::NEW_MONTH:
-                    onNewMonth();
+                    receiveNewMonth();
                     break;
                 default:
                     break;
@@ -131,17 +130,32 @@ void Person::update(float dt)
                     break;
             }
         }
-    }
+    });
 
-    // AI
-    mShortTermBrain.process();
+    // Broadcast messages
+    mCity->getChannel().read(mChannelCursor, [&](const Message& message)
+    {
+        const City::Event& event = message.getInfo<City::Event>();
+        switch (event.type)
+        {
+            case City::Event::Type::NEW_MONTH:
+                receiveNewMonth();
+                break;
+            default:
+                break;
+        }
+    }, [&](std::size_t /*nbMissed*/)
+    {
+        // Only new months matter, missing several of them is like a long update
+        receiveNewMonth();
+    });
 
-    // Update the car if necessary
-    if (mState == State::VISIBLE)
-        mCar.update(dt);
+    // Process the new month in the update given by the phase of the person
+    if (mNewMonthPending && mCity->isMonthPhaseReached(mMailbox.getId()))
+        onNewMonth();
 
-    // Update needs
-    updateNeeds(dt);
+    // AI
+    mShortTermBrain.process();
 }
 
 Id Person::getId() const
@@ -156,22 +170,22 @@ void Person::setId(Id id)
 
 const std::string& Person::getFirstName() const
 {
-    return mFirstName;
+    return PersonGenerator::getFirstNames().get(mProfile->firstName);
 }
 
 const std::string& Person::getLastName() const
 {
-    return mLastName;
+    return PersonGenerator::getLastNames().get(mProfile->lastName);
 }
 
 std::string Person::getFullName() const
 {
-    return mFirstName + ' ' + mLastName;
+    return getFirstName() + ' ' + getLastName();
 }
 
 Person::Gender Person::getGender() const
 {
-    return mGender;
+    return mProfile->gender;
 }
 
 const City* Person::getCity() const
@@ -179,15 +193,23 @@ const City* Person::getCity() const
     return mCity;
 }
 
-void Person::setCity(const City* city, MessageBus* messageBus, bool alreadyAdded)
+void Person::setCity(const City* city, MessageBus* messageBus, CarPool* carPool, bool alreadyAdded)
 {
     mCity = city;
     mMessageBus = messageBus;
+    mCarPool = carPool;
+    // The car of a loaded driver belongs to the pool
+    if (mCar)
+        mCarPool->adopt(mCar);
+    // Needs start to decay when the person enters the city
+    if (!alreadyAdded || mNeedTimes[0] == NO_TIME)
+        mNeedTimes.fill(mCity->getHumanTime());
     if (!alreadyAdded)
     {
         mMessageBus->addMailbox(mMailbox);
+        mChannelCursor = mCity->getChannel().getCursor();
         // Create bank account
-        mMessageBus->send(Message::create(mMailbox.getId(), mCity->getBank().getMailboxId(), MessageType::BANK, mCity->getBank().createCreateAccountEvent(Bank::Account::Type::PERSON, mFunds)));
+        mMessageBus->send(Message::create(mMailbox.getId(), mCity->getBank().getMailboxId(), MessageType::BANK, mCity->getBank().createCreateAccountEvent(Bank::Account::Type::PERSON, mProfile->funds)));
     }
 }
 
@@ -203,7 +225,7 @@ Id Person::getMailboxId() const
 
 int Person::getAge(int year) const
 {
-    return year - mBirth;
+    return year - mProfile->birth;
 }
 
 Person::State Person::getState() const
@@ -214,6 +236,18 @@ Person::State Person::getState() const
 void Person::setState(Person::State state)
 {
     mState = state;
+    // Only visible persons have a car
+    if (mState == State::VISIBLE && !mCar)
+    {
+        mCar = mCarPool->checkOut(mProfile->carModel, this);
+        mCar->getKinematic().setPosition(mPosition);
+    }
+    else if (mState == State::INVISIBLE && mCar)
+    {
+        mPosition = mCar->getKinematic().getPosition();
+        mCarPool->checkIn(mCar);
+        mCar = nullptr;
+    }
 }
 
 const Lease* Person::getHome() const
@@ -269,19 +303,33 @@ GoodType Person::getConsumptionHabit() const
     return mConsumptionHabit;
 }
 
-Car& Person::getCar()
+Car* Person::getCar()
 {
     return mCar;
 }
 
-const Car& Person::getCar() const
+const Car* Person::getCar() const
 {
     return mCar;
 }
 
+Vector2f Person::getPosition() const
+{
+    if (mCar)
+        return mCar->getKinematic().getPosition();
+    return mPosition;
+}
+
+void Person::setPosition(const Vector2f& position)
+{
+    mPosition = position;
+    if (mCar)
+        mCar->getKinematic().setPosition(position);
+}
+
 Money Person::getInitialFunds() const
 {
-    return mFunds;
+    return mProfile->funds;
 }
 
 Id Person::getAccount() const
@@ -308,17 +356,21 @@ float Person::getDecayRate(Need need) const
 
 float Person::getNeed(Need need) const
 {
-    return mNeeds[static_cast<int>(need)];
+    int i = static_cast<int>(need);
+    return computeNeed(i, getNbMonthsSinceUpdate(i));
 }
 
 void Person::increaseNeed(Need need, float delta)
 {
-    mNeeds[static_cast<int>(need)] = clamp(mNeeds[static_cast<int>(need)] + delta, 0.0f, 1.0f);
+    int i = static_cast<int>(need);
+    updateNeed(i);
+    mNeeds[i] = clamp(mNeeds[i] + delta, 0.0f, 1.0f);
 }
 
 float Person::getAverageNeed(Need need) const
 {
-    return mAverageNeeds[static_cast<int>(need)];
+    int i = static_cast<int>(need);
+    return mAverageNeeds[i] + integrateNeed(i, getNbMonthsSinceUpdate(i));
 }
 
 double Person::getProductivity() const
@@ -328,7 +380,7 @@ double Person::getProductivity() const
 
 Qualification Person::getQualification() const
 {
-    return mQualification;
+    return mProfile->qualification;
 }
 
 GoalThink& Person::getShortTermBrain()
@@ -351,21 +403,68 @@ const GoalThink& Person::getLongTermBrain() const
     return mLongTermBrain;
 }
 
-void Person::updateNeeds(float dt)
+float Person::getBias(GoalEvaluator::Type type) const
 {
-    float dmonth = dt / mCity->getTimePerMonth();
-    for (int i = 0; i < static_cast<int>(Need::COUNT); ++i)
-    {
-        increaseNeed(static_cast<Need>(i), -dmonth * mDecayRates[i]);
-        mAverageNeeds[i] += dmonth * mNeeds[i];
-    }
+    return mBiases[static_cast<int>(type)];
+}
+
+void Person::setBias(GoalEvaluator::Type type, float bias)
+{
+    mBiases[static_cast<int>(type)] = bias;
+}
+
+float Person::getNbMonthsSinceUpdate(int i) const
+{
+    // Needs do not decay outside the city
+    if (!mCity || mNeedTimes[i] == NO_TIME)
+        return 0.0f;
+    return (mCity->getHumanTime() - mNeedTimes[i]) / mCity->getTimePerMonth();
+}
+
+float Person::computeNeed(int i, float dmonth) const
+{
+    return clamp(mNeeds[i] - dmonth * mDecayRates[i], 0.0f, 1.0f);
+}
+
+float Person::integrateNeed(int i, float dmonth) const
+{
+    // The need is linear until it reaches 0 or 1, then it is constant
+    float need = mNeeds[i];
+    float rate = mDecayRates[i];
+    float bound = rate > 0.0f ? 0.0f : 1.0f;
+    float duration = rate != 0.0f ? (need - bound) / rate : dmonth;
+    if (dmonth <= duration)
+        return dmonth * (need - 0.5f * rate * dmonth);
+    return 0.5f * (need + bound) * duration + (dmonth - duration) * bound;
+}
+
+void Person::updateNeed(int i)
+{
+    float dmonth = getNbMonthsSinceUpdate(i);
+    mAverageNeeds[i] += integrateNeed(i, dmonth);
+    mNeeds[i] = computeNeed(i, dmonth);
+    if (mCity)
+        mNeedTimes[i] = mCity->getHumanTime();
+}
+
+void Person::receiveNewMonth()
+{
+    // A month still pending is processed before the next one
+    if (mNewMonthPending)
+        onNewMonth();
+    mNewMonthPending = true;
+    if (mCity->isMonthPhaseReached(mMailbox.getId()))
+        onNewMonth();
 }
 
 void Person::onNewMonth()
 {
+    mNewMonthPending = false;
     mLastMonthBalance = mMonthBalance;
     mMonthBalance = mCity->getBank().getBalance(mAccount);
     mLongTermBrain.process();
     // Reset averages
+    for (int i = 0; i < static_cast<int>(Need::COUNT); ++i)
+        updateNeed(i);
     mAverageNeeds.fill(0.0f);
 }
@@ -17,13 +17,19 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <boost/serialization/version.hpp>
 #include "message/Mailbox.h"
+#include "message/Channel.h"
 #include "ai/GoalThink.h"
 #include "city/Car.h"
 #include "city/Money.h"
+#include "pcg/PersonGenerator.h"
 
 class MessageBus;
 class City;
+class CarPool;
 class Lease;
 class Work;
 enum class Qualification;
@@ -56,8 +62,9 @@ public:
 
     static constexpr unsigned int NB_EVALUATORS = 6;
 
-    Person(const std::string& firstName, const std::string& lastName, Gender gender, int birth,
-        const std::string& car, const std::array<float, static_cast<int>(Need::COUNT)>& decayRates,
+    // Names and car are indices in the tables of PersonGenerator
+    Person(std::uint32_t firstName, std::uint32_t lastName, Gender gender, int birth,
+        std::uint32_t car, const std::array<float, static_cast<int>(Need::COUNT)>& decayRates,
         double productivity, const std::array<float, NB_EVALUATORS>& biases, Money funds);
     ~Person();
 
@@ -72,7 +79,7 @@ public:
     Gender getGender() const;
     int getAge(int year) const;
     const City* getCity() const;
-    void setCity(const City* city, MessageBus* messageBus, bool alreadyAdded = false);
+    void setCity(const City* city, MessageBus* messageBus, CarPool* carPool, bool alreadyAdded = false);
     MessageBus* getMessageBus();
     Id getMailboxId() const;
 
@@ -90,9 +97,11 @@ public:
     std::string getWorkStatus() const;
     GoodType getConsumptionHabit() const;
 
-    // Car
-    Car& getCar();
-    const Car& getCar() const;
+    // Car, only available when the person is visible
+    Car* getCar();
+    const Car* getCar() const;
+    Vector2f getPosition() const;
+    void setPosition(const Vector2f& position);
 
     // Finance
     Money getInitialFunds() const;
@@ -117,17 +126,31 @@ public:
     const GoalThink& getShortTermBrain() const;
     GoalThink& getLongTermBrain();
     const GoalThink& getLongTermBrain() const;
+    float getBias(GoalEvaluator::Type type) const;
+    void setBias(GoalEvaluator::Type type, float bias);
 
 private:
+    // Data rarely used by the simulation
+    struct Profile
+    {
+        std::uint32_t firstName;
+        std::uint32_t lastName;
+        Gender gender;
+        int birth;
+        Money funds;
+        Qualification qualification;
+        std::uint32_t carModel;
+    };
+
     // Personal data
     Id mId;
-    std::string mFirstName;
-    std::string mLastName;
-    Gender mGender;
-    int mBirth;
+    std::unique_ptr<Profile> mProfile;
     const City* mCity;
     MessageBus* mMessageBus;
+    CarPool* mCarPool;
     Mailbox mMailbox;
+    Channel::Cursor mChannelCursor;
+    bool mNewMonthPending;
 
     // State
     State mState;
@@ -138,10 +161,10 @@ private:
     GoodType mConsumptionHabit;
 
     // Car
-    Car mCar;
+    Car* mCar;
+    Vector2f mPosition; // Last known position when the person does not drive
 
     // Finance
-    Money mFunds;
     Id mAccount;
     Money mLastMonthBalance;
     Money mMonthBalance;
@@ -152,35 +175,104 @@ private:
     // Needs (Physiological and security)
     std::array<float, static_cast<int>(Need::COUNT)> mNeeds;
     std::array<float, static_cast<int>(Need::COUNT)> mAverageNeeds;
+    // The needs decay linearly, they are only updated when they change
+    std::array<float, static_cast<int>(Need::COUNT)> mNeedTimes; // City time of the last update
 
     // Abilities
     float mProductivity;
-    Qualification mQualification;
 
     // AI
+    std::array<float, static_cast<int>(GoalEvaluator::Type::COUNT)> mBiases;
     GoalThink mShortTermBrain;
     GoalThink mLongTermBrain;
 
-    void updateNeeds(float dt);
+    // Needs
+    static constexpr float NO_TIME = -1.0f;
+    float getNbMonthsSinceUpdate(int i) const;
+    float computeNeed(int i, float dmonth) const;
+    float integrateNeed(int i, float dmonth) const;
+    void updateNeed(int i);
 
     // Events
+    void receiveNewMonth();
     void onNewMonth();
 
     // Serialization
     friend class boost::serialization::access;
 
-    Person() = default;
+    Person();
 
     template<typename Archive>
-    void serialize(Archive& ar, const unsigned int /*version*/)
+    void serialize(Archive& ar, const unsigned int version)
     {
-        ar & mId & mFirstName & mLastName & mGender & mBirth & mMailbox;
+        // Names are saved as strings so that saves do not depend on the order of the names
+        std::string firstName;
+        std::string lastName;
+        if (Archive::is_saving::value)
+        {
+            firstName = getFirstName();
+            lastName = getLastName();
+        }
+        ar & mId & firstName & lastName & mProfile->gender & mProfile->birth & mMailbox;
+        if (Archive::is_loading::value)
+        {
+            mProfile->firstName = PersonGenerator::getFirstNames().add(firstName);
+            mProfile->lastName = PersonGenerator::getLastNames().add(lastName);
+        }
+        if (version >= 1)
+            ar & mChannelCursor;
+        if (version >= 5)
+            ar & mNewMonthPending;
         ar & mState;
         ar & mHome & mWork & mConsumptionHabit;
-        ar & mCar;
-        ar & mFunds & mAccount & mLastMonthBalance & mMonthBalance;
+        serializeCar(ar, version);
+        ar & mProfile->funds & mAccount & mLastMonthBalance & mMonthBalance;
         ar & mDecayRates & mNeeds & mAverageNeeds;
-        ar & mProductivity & mQualification;
+        // The needs were updated every frame before version 3
+        if (version >= 3)
+            ar & mNeedTimes;
+        else
+            mNeedTimes.fill(NO_TIME);
+        ar & mProductivity & mProfile->qualification;
+        // The biases were stored in the brains before version 2
+        if (version >= 2)
+            ar & mBiases;
         ar & mShortTermBrain & mLongTermBrain;
     }
+
+    template<typename Archive>
+    void serializeCar(Archive& ar, const unsigned int version)
+    {
+        if (version >= 4)
+        {
+            std::string model;
+            if (Archive::is_saving::value)
+                model = PersonGenerator::getCarModels().get(mProfile->carModel);
+            ar & model & mPosition;
+            if (Archive::is_loading::value)
+                mProfile->carModel = PersonGenerator::getCarModels().add(model);
+            bool driving = mCar != nullptr;
+            ar & driving;
+            if (driving)
+            {
+                if (Archive::is_loading::value)
+                    mCar = new Car(); // Given to the car pool in setCity
+                ar & *mCar;
+            }
+        }
+        else
+        {
+            // Each person owned a car before version 4
+            Car* car = new Car();
+            ar & *car;
+            mProfile->carModel = car->getModel();
+            mPosition = car->getKinematic().getPosition();
+            if (mState == State::VISIBLE)
+                mCar = car; // Given to the car pool in setCity
+            else
+                delete car;
+        }
+    }
 };
+
+BOOST_CLASS_VERSION(Person, 5)
@@ -37,9 +37,8 @@ std::unique_ptr<Tile> Service::clone() const
 void Service::update()
 {
     // Read messages
-    while (!mMailbox.isEmpty())
+    mMailbox.drain([&](Message& message)
     {
-        Message message = mMailbox.get();
         if (message.type == MessageType::MARKET)
         {
             const Market<Work>::Event& event = message.getInfo<const Market<Work>::Event>();
@@ -55,7 +54,7 @@ void Service::update()
                     break;
             }
         }
-    }
+    });
 }
 
 void Service::tearDown()
@@ -19,6 +19,31 @@
 #include "resource/TextureManager.h"
 #include "resource/ImageManager.h"
 #include "render/sprite_intersection.h"
+#include "city/SpriteList.h"
+
+namespace
+{
+
+// Draw the sprites as they are added
+class SpriteDrawer : public SpriteList
+{
+public:
+    SpriteDrawer(sf::RenderTarget& target, const sf::RenderStates& states) : mTarget(target), mStates(states)
+    {
+
+    }
+
+    virtual void addSprite(const sf::Sprite& sprite) override
+    {
+        mTarget.draw(sprite, mStates);
+    }
+
+private:
+    sf::RenderTarget& mTarget;
+    const sf::RenderStates& mStates;
+};
+
+}
 
 TextureManager* Tile::sTextureManager = nullptr;
 ImageManager* Tile::sImageManager = nullptr;
@@ -163,7 +188,9 @@ Tile::~Tile()
 
 void Tile::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
-    target.draw(mSprite, states);
+    // The sprites are only listed in takeSnapshot
+    SpriteDrawer drawer(target, states);
+    takeSnapshot(drawer);
 }
 
 bool Tile::intersect(const sf::Vector2f& position) const
@@ -171,6 +198,11 @@ bool Tile::intersect(const sf::Vector2f& position) const
     return sprite_intersect(mSprite, *mMask, position);
 }
 
+void Tile::takeSnapshot(SpriteList& sprites) const
+{
+    sprites.addSprite(mSprite);
+}
+
 std::unique_ptr<Tile> Tile::clone() const
 {
     return std::make_unique<Tile>(mTextureName, mType, mCategory);
@@ -26,6 +26,7 @@
 
 class TextureManager;
 class ImageManager;
+class SpriteList;
 
 class Tile : public NonCopyable, public NonMovable, public sf::Drawable
 {
@@ -53,8 +54,9 @@ public:
     Tile(const std::string& name, Type type, Category category);
     virtual ~Tile();
 
-    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override; // Draw the sprites of takeSnapshot
     virtual bool intersect(const sf::Vector2f& position) const;
+    virtual void takeSnapshot(SpriteList& sprites) const; // Add the sprites of the tile in the order they are drawn
 
     virtual std::unique_ptr<Tile> clone() const;
 
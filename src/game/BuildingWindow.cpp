@@ -34,7 +34,7 @@
 #include "util/format.h"
 
 BuildingWindow::BuildingWindow(StylesheetManager* stylesheetManager, const Building& building) :
-    GuiWindow(format("%s %d", Tile::typeToString(building.getType()).c_str(), building.getId()), stylesheetManager->getStylesheet("window")),
+    GuiWindow(format("%s %llu", Tile::typeToString(building.getType()).c_str(), static_cast<unsigned long long>(building.getId())), stylesheetManager->getStylesheet("window")),
     mStylesheetManager(stylesheetManager), mBuilding(building),
     mImage(nullptr), mStockLabel(nullptr), mPreparedGoodsLabel(nullptr), mTable(nullptr)
 {
@@ -120,7 +120,7 @@ void BuildingWindow::update()
         for (std::size_t i = 0; i < leases.size(); ++i)
         {
             static_cast<GuiLabel*>(mTable->getCellContent(i, 0))->setString(leases[i]->getTenantName());
-            static_cast<GuiLabel*>(mTable->getCellContent(i, 1))->setString(format("$%.2f", leases[i]->getRent()));
+            static_cast<GuiLabel*>(mTable->getCellContent(i, 1))->setString(format("$%.2f", static_cast<double>(leases[i]->getRent())));
         }
     }
     else
@@ -138,7 +138,7 @@ void BuildingWindow::update()
         {
             static_cast<GuiLabel*>(mTable->getCellContent(i, 0))->setString((*employees)[i]->getEmployeeName());
             static_cast<GuiLabel*>(mTable->getCellContent(i, 1))->setString(Work::typeToString((*employees)[i]->getType()));
-            static_cast<GuiLabel*>(mTable->getCellContent(i, 2))->setString(format("$%.2f", (*employees)[i]->getSalary()));
+            static_cast<GuiLabel*>(mTable->getCellContent(i, 2))->setString(format("$%.2f", static_cast<double>((*employees)[i]->getSalary())));
         }
     }
 }
@@ -33,7 +33,7 @@ CitizensWindow::CitizensWindow(Id listenerId, MessageBus* messageBus, Stylesheet
     mMessageBus(messageBus), mStylesheetManager(stylesheetManager), mCity(city), mTable(nullptr)
 {
     mMessageBus->addMailbox(mMailbox);
-    mCity.subscribe(mMailbox.getId());
+    mCity.subscribe(mMailbox.getId(), topics(City::Event::Type::NEW_CITIZEN, City::Event::Type::CITIZEN_LEFT));
 }
 
 CitizensWindow::~CitizensWindow()
@@ -94,7 +94,7 @@ void CitizensWindow::update()
     {
         static_cast<GuiLabel*>(mTable->getCellContent(i, 1))->setString(format("%d", mCitizens[i]->getAge(mCity.getYear())));
         static_cast<GuiLabel*>(mTable->getCellContent(i, 2))->setString(mCitizens[i]->getWorkStatus());
-        static_cast<GuiLabel*>(mTable->getCellContent(i, 3))->setString(format("$%.2f", mCitizens[i]->getAccountBalance()));
+        static_cast<GuiLabel*>(mTable->getCellContent(i, 3))->setString(format("$%.2f", static_cast<double>(mCitizens[i]->getAccountBalance())));
         static_cast<GuiLabel*>(mTable->getCellContent(i, 4))->setString(format("%.0f", 100.0f * mCitizens[i]->getNeed(Person::Need::HAPPINESS)));
     }
 }
@@ -140,6 +140,7 @@ void Game::run()
         if (curState)
         {
             mInputEngine.pollEvents();
+            mMessageBus.sendPostedMessages();
             curState->handleMessages();
             curState->update(dt);
             mRenderEngine.clear();
@@ -17,6 +17,10 @@
 
 #include "game/GameStateEditor.h"
 #include <utility>
+#include <fstream>
+#include <thread>
+#include <string>
+#include "util/debug.h"
 #include "util/format.h"
 #include "render/RenderEngine.h"
 #include "input/InputEngine.h"
@@ -40,6 +44,7 @@
 #include "game/GoodsMarketWindow.h"
 #include "game/PoliciesWindow.h"
 #include "game/NewspaperWindow.h"
+#include "game/MessageBusWindow.h"
 #include "city/Car.h"
 
 GameStateEditor::GameStateEditor() :
@@ -47,8 +52,11 @@ GameStateEditor::GameStateEditor() :
     mCurrentTile(Tile::Type::GRASS), mGui(sGuiManager->getGui("editor")),
     mImmigrantsWindow(nullptr), mCitizensWindow(nullptr),
     mRentalMarketWindow(nullptr), mLaborMarketWindow(nullptr), mGoodsMarketWindow(nullptr),
-    mPoliciesWindow(nullptr), mNewspaperWindow(nullptr)
+    mPoliciesWindow(nullptr), mNewspaperWindow(nullptr), mMessageBusWindow(nullptr),
+    mNbCityRequests(0), mFrameInProgress(false), mRefreshPending(false), mPaused(true), mStopping(false)
 {
+    mUpdateTimes.fill(0);
+
     // Views
     sf::Vector2u viewportSize = sRenderEngine->getViewportSize();
     mGameView.setSize(sf::Vector2f(viewportSize));
@@ -62,10 +70,14 @@ GameStateEditor::GameStateEditor() :
     // Gui
     createGui();
     mGui->subscribe(mMailbox.getId());
+
+    // Simulation, it starts when the state is entered
+    mSimulationThread = std::thread(&GameStateEditor::simulate, this);
 }
 
 GameStateEditor::~GameStateEditor()
 {
+    stopSimulation();
     // Save city
     sf::Texture preview;
     generatePreview(sf::Vector2u(64, 64), preview);
@@ -90,17 +102,32 @@ void GameStateEditor::enter()
     mGui->setViewportSize(sRenderEngine->getViewportSize());
     // Subscribe to inputs
     mGui->setListen(true);
+    // Resume the simulation
+    std::unique_lock<std::mutex> lock = lockCity();
+    mPaused = false;
 }
 
 void GameStateEditor::handleMessages()
 {
+    // The simulation does not start a step until the end of update, so the city is waited for at most once per frame
+    mFrameInProgress = true;
     mGui->handleMessages();
 
+    // The city is only locked for the messages that need it
+    std::unique_lock<std::mutex> lock(mCityMutex, std::defer_lock);
+    // Closing a window unsubscribes it from the city or a market, which must not happen during a step
+    if (mGui->hasClosedWindows())
+    {
+        lock = lockCity();
+        mGui->removeClosedWindows();
+    }
     sf::Vector2i mousePosition = sInputEngine->getMousePosition();
     sf::Vector2f gamePosition = sRenderEngine->mapPixelToCoords(mousePosition, mGameView);
     while (!mMailbox.isEmpty())
     {
         Message message = mMailbox.get();
+        if (!lock.owns_lock() && needsCity(message))
+            lock = lockCity();
         if (message.type == MessageType::INPUT)
         {
             const InputEvent& event = message.getInfo<InputEvent>();
@@ -122,6 +149,16 @@ void GameStateEditor::handleMessages()
                         mGui->setVisible(!mGui->isVisible());
                     else if (event.key.code == sf::Keyboard::S)
                         mRenderTexture.getTexture().copyToImage().saveToFile("screenshot.png");
+                    else if (event.key.code == sf::Keyboard::M)
+                        saveStatistics();
+                    else if (event.key.code == sf::Keyboard::B)
+                        openMessageBusWindow();
+                    else if (event.key.code == sf::Keyboard::A)
+                        toggleBatchArbitration();
+                    else if (event.key.code == sf::Keyboard::T)
+                        toggleStaggeredMonths();
+                    else if (event.key.code == sf::Keyboard::P)
+                        toggleThreads();
                     else if (event.key.code == sf::Keyboard::LControl &&
                         sInputEngine->isButtonPressed(sf::Mouse::Button::Left))
                         startPanning(mousePosition);
@@ -150,7 +187,7 @@ void GameStateEditor::handleMessages()
                         // Update the GUI
                         Money totalCost = computeCostOfSelection();
                         GuiLabel* selectionCostText = mGui->get<GuiLabel>("selectionCostText");
-                        selectionCostText->setString(format("$%.2f", totalCost));
+                        selectionCostText->setString(format("$%.2f", static_cast<double>(totalCost)));
                         if (mCity.getFunds() < totalCost)
                             selectionCostText->setColor(sf::Color::Red);
                         else
@@ -283,8 +320,10 @@ void GameStateEditor::handleMessages()
                         mGoodsMarketWindow = nullptr;
                     else if (mPoliciesWindow == window)
                         mPoliciesWindow = nullptr;
-                    else if (mNewspaperWindow == nullptr)
+                    else if (mNewspaperWindow == window)
                         mNewspaperWindow = nullptr;
+                    else if (mMessageBusWindow == window)
+                        mMessageBusWindow = nullptr;
                     else
                     {
                         for (WindowManager& windowManager : mWindowManagers)
@@ -340,30 +379,42 @@ void GameStateEditor::handleMessages()
             }
         }
     }
+    updateSnapshotView();
 }
 
-void GameStateEditor::update(float dt)
+void GameStateEditor::update(float /*dt*/)
 {
     sAudioEngine->update();
-    mCity.update(dt);
+    // The city is updated by the simulation thread, the last snapshot is used so that it is not waited for
+    mSnapshots.update();
+    const CitySnapshot& snapshot = mSnapshots.getFront();
 
     // Update the info bar at the bottom of the screen
-    mGui->get<GuiLabel>("dateText")->setString(mCity.getPrettyDate());
-    mGui->get<GuiLabel>("fundsText")->setString(format("$%.2f", mCity.getFunds()));
-    mGui->get<GuiLabel>("populationText")->setString(format("Population: %d", mCity.getPopulation()));
-    mGui->get<GuiLabel>("happinessText")->setString(format("Happiness: %.0f", 100.0f * mCity.getAverageHappiness()));
+    mGui->get<GuiLabel>("dateText")->setString(snapshot.getDate());
+    mGui->get<GuiLabel>("fundsText")->setString(format("$%.2f", static_cast<double>(snapshot.getFunds())));
+    mGui->get<GuiLabel>("populationText")->setString(format("Population: %d", snapshot.getPopulation()));
+    mGui->get<GuiLabel>("happinessText")->setString(format("Happiness: %.0f", 100.0f * snapshot.getAverageHappiness()));
     mGui->get<GuiLabel>("currentTileText")->setString(Tile::typeToString(mCurrentTile));
 
-    // Update the windows
-    updateWindows();
+    // Update the windows if no step is in progress, otherwise the next frame does it before the next step
+    {
+        std::unique_lock<std::mutex> lock(mCityMutex, std::try_to_lock);
+        mRefreshPending = !lock.owns_lock();
+        if (lock.owns_lock())
+            updateWindows();
+    }
 
     mGui->update();
+
+    // End of the frame, the simulation can continue
+    mFrameInProgress = false;
+    mCityCondition.notify_one();
 }
 
 void GameStateEditor::draw()
 {
-    // City
-    drawCity(mRenderTexture, mGameView, true);
+    // City, from the snapshot of update
+    drawCity(mRenderTexture, mGameView, mSnapshots.getFront(), true);
 
     // GUI
     sRenderEngine->setView(mGui->getView());
@@ -375,6 +426,9 @@ void GameStateEditor::exit()
 {
     // Unsubscribe to inputs
     mGui->setListen(false);
+    // Pause the simulation
+    std::unique_lock<std::mutex> lock = lockCity();
+    mPaused = true;
 }
 
 void GameStateEditor::newGame(std::string cityName, uint64_t seed)
@@ -387,7 +441,9 @@ void GameStateEditor::newGame(std::string cityName, uint64_t seed)
 
     // Subscribe to the city
     mCity.setGameMessageBus(sMessageBus);
-    mCity.subscribe(mMailbox.getId());
+    mCity.subscribe(mMailbox.getId(), Subject::topics(City::Event::Type::NEW_YEAR, City::Event::Type::BUILDING_DESTROYED, City::Event::Type::CITIZEN_LEFT));
+    updateSnapshotView();
+    publishSnapshot();
 
     // Open the newspaper window
     openNewspaperWindow();
@@ -403,7 +459,9 @@ void GameStateEditor::loadGame(const std::string& cityName)
 
     // Subscribe to the city
     mCity.setGameMessageBus(sMessageBus);
-    mCity.subscribe(mMailbox.getId());
+    mCity.subscribe(mMailbox.getId(), Subject::topics(City::Event::Type::NEW_YEAR, City::Event::Type::BUILDING_DESTROYED, City::Event::Type::CITIZEN_LEFT));
+    updateSnapshotView();
+    publishSnapshot();
 }
 
 const sf::Texture& GameStateEditor::getCityTexture() const
@@ -411,7 +469,7 @@ const sf::Texture& GameStateEditor::getCityTexture() const
     return mRenderTexture.getTexture();
 }
 
-void GameStateEditor::drawCity(sf::RenderTexture& renderTexture, const sf::View& view, bool background)
+void GameStateEditor::drawCity(sf::RenderTexture& renderTexture, const sf::View& view, const sf::Drawable& city, bool background)
 {
     renderTexture.clear(sf::Color::Transparent);
     if (background)
@@ -420,10 +478,106 @@ void GameStateEditor::drawCity(sf::RenderTexture& renderTexture, const sf::View&
         renderTexture.draw(mBackground);
     }
     renderTexture.setView(view);
-    renderTexture.draw(mCity);
+    renderTexture.draw(city);
     renderTexture.display();
 }
 
+void GameStateEditor::simulate()
+{
+    std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mCityMutex);
+    while (!mStopping)
+    {
+        if (mPaused)
+        {
+            mCityCondition.wait(lock, [this]{ return mStopping || !mPaused; });
+            // The time spent paused is not simulated
+            last = std::chrono::steady_clock::now();
+        }
+        else if (mNbCityRequests > 0 || mFrameInProgress || mRefreshPending)
+        {
+            // Let the main thread use the city, the flags are changed without the mutex so the wait is bounded
+            mCityCondition.wait_for(lock, std::chrono::duration<float>(MIN_TIME_STEP),
+                [this]{ return mNbCityRequests == 0 && !mFrameInProgress && !mRefreshPending; });
+        }
+        else
+        {
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            float dt = std::chrono::duration<float>(now - last).count();
+            if (dt < MIN_TIME_STEP)
+            {
+                // Release the city until the next step
+                lock.unlock();
+                std::this_thread::sleep_for(std::chrono::duration<float>(MIN_TIME_STEP - dt));
+                lock.lock();
+            }
+            else
+            {
+                last = now;
+                mCity.update(dt);
+                recordUpdateTime(std::chrono::steady_clock::now() - now);
+                publishSnapshot();
+            }
+        }
+    }
+}
+
+void GameStateEditor::stopSimulation()
+{
+    {
+        std::unique_lock<std::mutex> lock = lockCity();
+        mStopping = true;
+    }
+    mCityCondition.notify_one();
+    mSimulationThread.join();
+}
+
+std::unique_lock<std::mutex> GameStateEditor::lockCity()
+{
+    // The simulation thread does not start a new step while there are requests
+    ++mNbCityRequests;
+    std::unique_lock<std::mutex> lock(mCityMutex);
+    --mNbCityRequests;
+    // Wake it up so that it continues when the mutex is unlocked
+    mCityCondition.notify_one();
+    return lock;
+}
+
+bool GameStateEditor::needsCity(const Message& message) const
+{
+    if (message.type != MessageType::INPUT)
+        return true;
+    const InputEvent& event = message.getInfo<InputEvent>();
+    switch (event.type)
+    {
+        case sf::Event::KeyPressed:
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::MouseButtonReleased:
+            return true;
+        case sf::Event::MouseMoved:
+            return mActionState == ActionState::SELECTING;
+        default:
+            return false;
+    }
+}
+
+void GameStateEditor::updateSnapshotView()
+{
+    std::lock_guard<std::mutex> lock(mViewMutex);
+    mSnapshotView = mGameView;
+}
+
+void GameStateEditor::publishSnapshot()
+{
+    sf::View view;
+    {
+        std::lock_guard<std::mutex> lock(mViewMutex);
+        view = mSnapshotView;
+    }
+    mCity.takeSnapshot(view, mSnapshots.getBack());
+    mSnapshots.publish();
+}
+
 void GameStateEditor::generatePreview(sf::Vector2u size, sf::Texture& texture)
 {
     // Prepare to render
@@ -435,7 +589,7 @@ void GameStateEditor::generatePreview(sf::Vector2u size, sf::Texture& texture)
     float factor = 1.05;
     view.setSize(factor * width, factor * width * float(size.y) / float(size.x));
     // Render
-    drawCity(renderTexture, view, false);
+    drawCity(renderTexture, view, mCity, false);
     // Save
     texture = renderTexture.getTexture();
 }
@@ -603,6 +757,37 @@ void GameStateEditor::openNewspaperWindow()
     }
 }
 
+void GameStateEditor::toggleBatchArbitration()
+{
+    mCity.setBatchArbitrationEnabled(!mCity.isBatchArbitrationEnabled());
+    DEBUG("Batch arbitration: " << (mCity.isBatchArbitrationEnabled() ? "on" : "off") << "\n");
+}
+
+void GameStateEditor::toggleStaggeredMonths()
+{
+    mCity.setMonthsStaggered(!mCity.areMonthsStaggered());
+    // Restart the histogram to compare the update times of both modes
+    mUpdateTimes.fill(0);
+    DEBUG("Staggered months: " << (mCity.areMonthsStaggered() ? "on" : "off") << "\n");
+}
+
+void GameStateEditor::toggleThreads()
+{
+    mCity.setNbThreads(mCity.getNbThreads() > 1 ? 1 : std::thread::hardware_concurrency());
+    // Restart the histogram to compare the update times of both modes
+    mUpdateTimes.fill(0);
+    DEBUG("Threads: " << mCity.getNbThreads() << "\n");
+}
+
+void GameStateEditor::openMessageBusWindow()
+{
+    if (!mMessageBusWindow)
+    {
+        mMessageBusWindow = mGui->createRootWithDefaultName<MessageBusWindow>(sStylesheetManager, mCity.getMessageBusStatistics());
+        mMessageBusWindow->subscribe(mMailbox.getId());
+    }
+}
+
 void GameStateEditor::updateWindows()
 {
     if (mImmigrantsWindow)
@@ -615,18 +800,20 @@ void GameStateEditor::updateWindows()
         mLaborMarketWindow->update();
     if (mGoodsMarketWindow)
         mGoodsMarketWindow->update();
+    if (mMessageBusWindow)
+        mMessageBusWindow->update();
     if (mPoliciesWindow)
         mPoliciesWindow->update();
     for (GuiWindow* window : mWindowManagers[0].getWindows())
     {
         PersonWindow* personWindow = static_cast<PersonWindow*>(window);
-        drawCity(personWindow->getRenderTexture(), personWindow->getView(), true);
+        drawCity(personWindow->getRenderTexture(), personWindow->getView(), mCity, true);
         personWindow->update();
     }
     for (GuiWindow* window : mWindowManagers[1].getWindows())
     {
         BuildingWindow* buildingWindow = static_cast<BuildingWindow*>(window);
-        drawCity(buildingWindow->getRenderTexture(), buildingWindow->getView(), true);
+        drawCity(buildingWindow->getRenderTexture(), buildingWindow->getView(), mCity, true);
         buildingWindow->update();
     }
 }
@@ -732,9 +919,62 @@ Money GameStateEditor::computeCostOfSelection() const
     return Money(getCost(mCurrentTile) * mCity.getMap().getNbSelected());
 }
 
+void GameStateEditor::saveStatistics() const
+{
+    for (int i = 0; i < static_cast<int>(MarketType::COUNT); ++i)
+    {
+        std::ofstream file(format("market%d.csv", i));
+        if (file)
+            mCity.getMarket(static_cast<MarketType>(i))->writeStatisticsCsv(file);
+        else
+            DEBUG("Fail to save the statistics of market " << i << "\n");
+        std::ofstream binaryFile(format("market%d.bin", i), std::ios::out | std::ios::binary);
+        if (binaryFile)
+            mCity.getMarket(static_cast<MarketType>(i))->writeStatisticsBinary(binaryFile);
+        else
+            DEBUG("Fail to save the binary statistics of market " << i << "\n");
+    }
+    std::ofstream file("messages.csv");
+    if (file)
+        mCity.getMessageBusStatistics().writeCsv(file);
+    else
+        DEBUG("Fail to save the statistics of the message bus\n");
+    std::ofstream updatesFile(mCity.areMonthsStaggered() ? "updates_staggered.csv" : "updates.csv");
+    if (updatesFile)
+    {
+        updatesFile << "bucket (us),updates\n";
+        for (std::size_t i = 0; i < mUpdateTimes.size(); ++i)
+            updatesFile << (i == 0 ? 0ull : 1ull << (i - 1)) << ',' << mUpdateTimes[i] << '\n';
+    }
+    else
+        DEBUG("Fail to save the update times\n");
+    std::ofstream goalsFile("goals.csv");
+    if (goalsFile)
+        mCity.writeGoalAllocationsCsv(goalsFile);
+    else
+        DEBUG("Fail to save the allocations of goals\n");
+    std::ofstream tasksFile("tasks.csv");
+    if (tasksFile)
+        mCity.getScheduler().writeTimingsCsv(tasksFile);
+    else
+        DEBUG("Fail to save the times of the tasks\n");
+}
+
+void GameStateEditor::recordUpdateTime(std::chrono::steady_clock::duration duration)
+{
+    long long microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    std::size_t bucket = 0;
+    while (microseconds > 0 && bucket < NB_UPDATE_TIME_BUCKETS - 1)
+    {
+        microseconds >>= 1;
+        ++bucket;
+    }
+    ++mUpdateTimes[bucket];
+}
+
 Id GameStateEditor::extractId(const std::string& name, const std::string& prefix) const
 {
-    return std::atoi(name.substr(prefix.size(), name.find("|", prefix.size()) - prefix.size()).c_str());
+    return std::stoull(name.substr(prefix.size(), name.find("|", prefix.size()) - prefix.size()));
 }
 
 void GameStateEditor::onNewYear()
@@ -17,9 +17,17 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <SFML/Graphics.hpp>
+#include "util/TripleBuffer.h"
 #include "game/GameState.h"
 #include "city/City.h"
+#include "city/CitySnapshot.h"
 #include "gui/Gui.h"
 #include "game/WindowManager.h"
 
@@ -30,6 +38,7 @@ class LaborMarketWindow;
 class GoodsMarketWindow;
 class PoliciesWindow;
 class NewspaperWindow;
+class MessageBusWindow;
 
 enum class ActionState{NONE, PANNING, SELECTING};
 
@@ -51,6 +60,9 @@ public:
     const sf::Texture& getCityTexture() const;
 
 private:
+    static constexpr std::size_t NB_UPDATE_TIME_BUCKETS = 20;
+    static constexpr float MIN_TIME_STEP = 1.0f / 120.0f; // In seconds, the simulation does not update more often
+
     sf::RenderTexture mRenderTexture;
     sf::View mGameView;
     sf::Sprite mBackground;
@@ -71,11 +83,34 @@ private:
     GoodsMarketWindow* mGoodsMarketWindow;
     PoliciesWindow* mPoliciesWindow;
     NewspaperWindow* mNewspaperWindow;
+    MessageBusWindow* mMessageBusWindow;
     std::vector<std::unique_ptr<sf::RenderTexture>> mMenuTextures;
+    // Statistics
+    std::array<unsigned long long, NB_UPDATE_TIME_BUCKETS> mUpdateTimes; // Bucket 0 counts durations below 1us, bucket i > 0 those in [2^(i-1), 2^i) us
+    // Simulation
+    std::mutex mCityMutex; // The city and the gui that reads it are only used with this mutex locked
+    std::condition_variable mCityCondition;
+    std::atomic<int> mNbCityRequests; // Number of times the main thread waits for the city
+    std::atomic<bool> mFrameInProgress; // From handleMessages to the end of update, no step starts meanwhile
+    std::atomic<bool> mRefreshPending; // The windows were not refreshed as a step was in progress, no step starts before they are
+    bool mPaused;
+    bool mStopping;
+    TripleBuffer<CitySnapshot> mSnapshots;
+    std::mutex mViewMutex;
+    sf::View mSnapshotView; // Copy of the game view for the simulation thread, used with mViewMutex locked
+    std::thread mSimulationThread;
 
-    void drawCity(sf::RenderTexture& renderTexture, const sf::View& view, bool background);
+    void drawCity(sf::RenderTexture& renderTexture, const sf::View& view, const sf::Drawable& city, bool background);
     void generatePreview(sf::Vector2u size, sf::Texture& texture);
 
+    // Simulation
+    void simulate(); // Loop of the simulation thread
+    void stopSimulation();
+    std::unique_lock<std::mutex> lockCity(); // Wait for the end of the current step
+    bool needsCity(const Message& message) const; // False if the message only changes the view or the gui
+    void updateSnapshotView();
+    void publishSnapshot();
+
     // Gui
     void createGui();
     void generateMenuTextures();
@@ -88,6 +123,10 @@ private:
     void openGoodsMarketWindow();
     void openPoliciesWindow();
     void openNewspaperWindow();
+    void openMessageBusWindow();
+    void toggleBatchArbitration();
+    void toggleStaggeredMonths();
+    void toggleThreads();
     void updateWindows();
     bool updateTabs(const std::string& name);
     bool updateTile(const std::string& name);
@@ -102,6 +141,9 @@ private:
     Money getCost(Tile::Type type) const;
     Money computeCostOfSelection() const;
 
+    void recordUpdateTime(std::chrono::steady_clock::duration duration);
+    void saveStatistics() const;
+
     Id extractId(const std::string& name, const std::string& prefix) const;
 
     // Events
@@ -36,7 +36,7 @@ GoodsMarketWindow::GoodsMarketWindow(MessageBus* messageBus, StylesheetManager*
 {
     mMessageBus->addMailbox(mMailbox);
     for (Market<Good>* market : mMarkets)
-        market->subscribe(mMailbox.getId());
+        market->subscribe(mMailbox.getId(), topics(Market<Good>::Event::Type::ITEM_ADDED, Market<Good>::Event::Type::ITEM_REMOVED));
 }
 
 GoodsMarketWindow::~GoodsMarketWindow()
@@ -134,9 +134,9 @@ void GoodsMarketWindow::addRow(const Building* building, GoodType goodType, Mone
     // Add row
     mTable->addRow({
         mGui->createWithDefaultName<GuiLabel>(building->getOwner()->getName(), 12, mStylesheetManager->getStylesheet("darkText")),
-        mGui->createWithDefaultName<GuiLabel>(format("%d", building->getId()), 12, mStylesheetManager->getStylesheet("darkText")),
+        mGui->createWithDefaultName<GuiLabel>(format("%llu", static_cast<unsigned long long>(building->getId())), 12, mStylesheetManager->getStylesheet("darkText")),
         mGui->createWithDefaultName<GuiLabel>(Good::typeToString(goodType), 12, mStylesheetManager->getStylesheet("darkText")),
-        mGui->createWithDefaultName<GuiLabel>(format("$%.2f", price), 12, mStylesheetManager->getStylesheet("darkText")),
+        mGui->createWithDefaultName<GuiLabel>(format("$%.2f", static_cast<double>(price)), 12, mStylesheetManager->getStylesheet("darkText")),
         mGui->createWithDefaultName<GuiLabel>(format("%d", count), 12, mStylesheetManager->getStylesheet("darkText")),
     });
 }
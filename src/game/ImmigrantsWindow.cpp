@@ -37,7 +37,7 @@ ImmigrantsWindow::ImmigrantsWindow(Id listenerId, MessageBus* messageBus, Styles
     mTable(nullptr), mRentalMarketLabel(nullptr), mLaborMarketLabel(nullptr), mAttractivenessLabel(nullptr)
 {
     mMessageBus->addMailbox(mMailbox);
-    mCity.subscribe(mMailbox.getId());
+    mCity.subscribe(mMailbox.getId(), topics(City::Event::Type::NEW_IMMIGRANT, City::Event::Type::IMMIGRANT_EJECTED, City::Event::Type::NEW_CITIZEN));
 }
 
 ImmigrantsWindow::~ImmigrantsWindow()
@@ -150,7 +150,7 @@ void ImmigrantsWindow::addImmigrant(Person* person)
     mTable->addRow({
         mGui->createWithDefaultName<GuiLabel>(fullName, 12, mStylesheetManager->getStylesheet("darkText")),
         mGui->createWithDefaultName<GuiLabel>(format("%d", person->getAge(mCity.getYear())), 12, mStylesheetManager->getStylesheet("darkText")),
-        mGui->createWithDefaultName<GuiLabel>(format("$%.2f", person->getInitialFunds()), 12, mStylesheetManager->getStylesheet("darkText")),
+        mGui->createWithDefaultName<GuiLabel>(format("$%.2f", static_cast<double>(person->getInitialFunds())), 12, mStylesheetManager->getStylesheet("darkText")),
         visaButtons
     });
 }
@@ -35,7 +35,7 @@ LaborMarketWindow::LaborMarketWindow(MessageBus* messageBus, StylesheetManager*
     mMessageBus(messageBus), mStylesheetManager(stylesheetManager), mMarket(market), mTable(nullptr)
 {
     mMessageBus->addMailbox(mMailbox);
-    mMarket->subscribe(mMailbox.getId());
+    mMarket->subscribe(mMailbox.getId(), topics(Market<Work>::Event::Type::ITEM_ADDED, Market<Work>::Event::Type::ITEM_REMOVED));
 }
 
 LaborMarketWindow::~LaborMarketWindow()
@@ -127,9 +127,9 @@ void LaborMarketWindow::addRow(const Building* building, WorkType type, Money sa
     // Add row
     mTable->addRow({
         mGui->createWithDefaultName<GuiLabel>(building->getOwner()->getName(), 12, mStylesheetManager->getStylesheet("darkText")),
-        mGui->createWithDefaultName<GuiLabel>(format("%d", building->getId()), 12, mStylesheetManager->getStylesheet("darkText")),
+        mGui->createWithDefaultName<GuiLabel>(format("%llu", static_cast<unsigned long long>(building->getId())), 12, mStylesheetManager->getStylesheet("darkText")),
         mGui->createWithDefaultName<GuiLabel>(Work::typeToString(type), 12, mStylesheetManager->getStylesheet("darkText")),
-        mGui->createWithDefaultName<GuiLabel>(format("$%.2f", salary), 12, mStylesheetManager->getStylesheet("darkText")),
+        mGui->createWithDefaultName<GuiLabel>(format("$%.2f", static_cast<double>(salary)), 12, mStylesheetManager->getStylesheet("darkText")),
         mGui->createWithDefaultName<GuiLabel>(format("%d", count), 12, mStylesheetManager->getStylesheet("darkText")),
     });
 }
@@ -0,0 +1,88 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MessageBusWindow.h"
+#include <sstream>
+#include "resource/StylesheetManager.h"
+#include "gui/Gui.h"
+#include "gui/GuiLabel.h"
+#include "gui/GuiTable.h"
+#include "gui/GuiVBoxLayout.h"
+#include "message/MessageBusStatistics.h"
+#include "util/format.h"
+
+MessageBusWindow::MessageBusWindow(StylesheetManager* stylesheetManager, const MessageBusStatistics& statistics) :
+    GuiWindow("Message bus", stylesheetManager->getStylesheet("window")), mStylesheetManager(stylesheetManager),
+    mStatistics(statistics), mTable(nullptr), mUndeliveredLabel(nullptr), mLatencyLabel(nullptr), mDepthsLabel(nullptr)
+{
+
+}
+
+MessageBusWindow::~MessageBusWindow()
+{
+
+}
+
+void MessageBusWindow::setUp()
+{
+    // Create table
+    std::vector<std::string> names{"Type", "Messages"};
+    mTable = mGui->createWithDefaultName<GuiTable>(names, mStylesheetManager->getStylesheet("table"));
+    for (int i = 0; i <= static_cast<int>(MessageType::BUSINESS); ++i)
+    {
+        std::ostringstream type;
+        type << static_cast<MessageType>(i);
+        mTable->addRow({
+            mGui->createWithDefaultName<GuiLabel>(type.str(), 12, mStylesheetManager->getStylesheet("darkText")),
+            mGui->createWithDefaultName<GuiLabel>("", 12, mStylesheetManager->getStylesheet("darkText"))
+        });
+    }
+
+    // Labels
+    mUndeliveredLabel = mGui->createWithDefaultName<GuiLabel>("", 12, mStylesheetManager->getStylesheet("darkText"));
+    mLatencyLabel = mGui->createWithDefaultName<GuiLabel>("", 12, mStylesheetManager->getStylesheet("darkText"));
+    mDepthsLabel = mGui->createWithDefaultName<GuiLabel>("", 12, mStylesheetManager->getStylesheet("darkText"));
+
+    // Window
+    add(mTable);
+    add(mUndeliveredLabel);
+    add(mLatencyLabel);
+    add(mDepthsLabel);
+    setOutsidePosition(sf::Vector2f(50.0f, 50.0f));
+    setLayout(std::make_unique<GuiVBoxLayout>(8.0f, GuiLayout::Margins{8.0f, 8.0f, 8.0f, 8.0f}));
+    applyStyle();
+}
+
+void MessageBusWindow::update()
+{
+    // Update the cells
+    for (int i = 0; i <= static_cast<int>(MessageType::BUSINESS); ++i)
+        static_cast<GuiLabel*>(mTable->getCellContent(i, 1))->setString(format("%llu", mStatistics.getNbMessages(static_cast<MessageType>(i))));
+
+    // Update texts
+    mUndeliveredLabel->setString(format("Undelivered: %llu, coalesced: %llu", mStatistics.getNbUndelivered(), mStatistics.getNbCoalesced()));
+    mLatencyLabel->setString(format("Latency: %.2f ticks on average, %u at most", mStatistics.getMeanLatency(), mStatistics.getMaxLatency()));
+    std::string depths = "Depths:";
+    const MessageBusStatistics::Histogram& histogram = mStatistics.getDepths();
+    for (std::size_t i = 0; i < histogram.size(); ++i)
+    {
+        if (histogram[i] > 0)
+            depths += format(" %llu+: %llu", (i == 0 ? 0ull : 1ull << (i - 1)), histogram[i]);
+    }
+    mDepthsLabel->setString(depths);
+}
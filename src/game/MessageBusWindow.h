@@ -0,0 +1,45 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "gui/GuiWindow.h"
+
+class StylesheetManager;
+class GuiTable;
+class GuiLabel;
+class MessageBusStatistics;
+
+class MessageBusWindow : public GuiWindow
+{
+public:
+    MessageBusWindow(StylesheetManager* stylesheetManager, const MessageBusStatistics& statistics);
+    virtual ~MessageBusWindow();
+
+    virtual void setUp() override;
+
+    void update();
+
+private:
+    StylesheetManager* mStylesheetManager;
+    const MessageBusStatistics& mStatistics;
+    GuiTable* mTable;
+    GuiLabel* mUndeliveredLabel;
+    GuiLabel* mLatencyLabel;
+    GuiLabel* mDepthsLabel;
+};
@@ -94,7 +94,7 @@ void PersonWindow::update()
 {
     mAgeLabel->setString(format("Age: %d", mPerson.getAge(mYear)));
     mWorkLabel->setString("Work: " + mPerson.getWorkStatus());
-    mBankAccountLabel->setString(format("Bank account: $%.2f", mPerson.getAccountBalance()));
+    mBankAccountLabel->setString(format("Bank account: $%.2f", static_cast<double>(mPerson.getAccountBalance())));
     mShortTermGoalLabel->setString("Short term goal: " + mPerson.getShortTermBrain().toString());
     mLongTermGoalLabel->setString("Long term goal: " + mPerson.getLongTermBrain().toString());
     mEnergyLabel->setString(format("Energy: %.2f", mPerson.getNeed(Person::Need::ENERGY)));
@@ -121,6 +121,6 @@ sf::RenderTexture& PersonWindow::getRenderTexture()
 
 sf::View PersonWindow::getView()
 {
-    sf::Vector2f center = mPerson.getCar().getKinematic().getPosition();
+    sf::Vector2f center = mPerson.getPosition();
     return sf::View(center, sf::Vector2f(mRenderTexture.getSize()));
 }
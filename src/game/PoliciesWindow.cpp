@@ -68,25 +68,25 @@ void PoliciesWindow::setUp()
     laborPolicyTab->setLayout(std::make_unique<GuiVBoxLayout>(4.0f, GuiLayout::Margins{8.0f, 8.0f, 8.0f, 8.0f}));
 
     createLine(laborPolicyTab, "Weekly standard working hours: ", format("%d", mCity.getWeeklyStandardWorkingHours()), regexNumbersUntil(24 * 7));
-    createLine(laborPolicyTab, "Minimum wage: $", format("%.2f", mCity.getMinimumWage()), "\\d{0,9}(\\.\\d{0,2})?");
+    createLine(laborPolicyTab, "Minimum wage: $", format("%.2f", static_cast<double>(mCity.getMinimumWage())), "\\d{0,9}(\\.\\d{0,2})?");
 
     // Housing policy
     GuiWidget* housingPolicyTab = mGui->createWithDefaultName<GuiWidget>(mStylesheetManager->getStylesheet("windowTabs"));
     housingPolicyTab->setFixedInsideSize(sf::Vector2f(400.0f, 100.0f));
     housingPolicyTab->setLayout(std::make_unique<GuiVBoxLayout>(4.0f, GuiLayout::Margins{8.0f, 8.0f, 8.0f, 8.0f}));
 
-    createLine(housingPolicyTab, "Rent for an affordable housing: $", format("%.2f", mCity.getCompany().getRent(Tile::Type::AFFORDABLE_HOUSING)), "\\d{0,9}(\\.\\d{0,2})?");
-    createLine(housingPolicyTab, "Rent for an apartment: $", format("%.2f", mCity.getCompany().getRent(Tile::Type::APARTMENT_BUILDING)), "\\d{0,9}(\\.\\d{0,2})?");
-    createLine(housingPolicyTab, "Rent for a villa: $", format("%.2f", mCity.getCompany().getRent(Tile::Type::VILLA)), "\\d{0,9}(\\.\\d{0,2})?");
+    createLine(housingPolicyTab, "Rent for an affordable housing: $", format("%.2f", static_cast<double>(mCity.getCompany().getRent(Tile::Type::AFFORDABLE_HOUSING))), "\\d{0,9}(\\.\\d{0,2})?");
+    createLine(housingPolicyTab, "Rent for an apartment: $", format("%.2f", static_cast<double>(mCity.getCompany().getRent(Tile::Type::APARTMENT_BUILDING))), "\\d{0,9}(\\.\\d{0,2})?");
+    createLine(housingPolicyTab, "Rent for a villa: $", format("%.2f", static_cast<double>(mCity.getCompany().getRent(Tile::Type::VILLA))), "\\d{0,9}(\\.\\d{0,2})?");
 
     // Public service
     GuiWidget* publicServiceTab = mGui->createWithDefaultName<GuiWidget>(mStylesheetManager->getStylesheet("windowTabs"));
     publicServiceTab->setFixedInsideSize(sf::Vector2f(400.0f, 100.0f));
     publicServiceTab->setLayout(std::make_unique<GuiVBoxLayout>(4.0f, GuiLayout::Margins{8.0f, 8.0f, 8.0f, 8.0f}));
 
-    createLine(publicServiceTab, "Salary of a non-qualified job: $", format("%.2f", mCity.getCompany().getSalary(Qualification::NON_QUALIFIED)), "\\d{0,9}(\\.\\d{0,2})?");
-    createLine(publicServiceTab, "Salary of a qualified job: $", format("%.2f", mCity.getCompany().getSalary(Qualification::QUALIFIED)), "\\d{0,9}(\\.\\d{0,2})?");
-    createLine(publicServiceTab, "Salary of a highly qualified job: $", format("%.2f", mCity.getCompany().getSalary(Qualification::HIGHLY_QUALIFIED)), "\\d{0,9}(\\.\\d{0,2})?");
+    createLine(publicServiceTab, "Salary of a non-qualified job: $", format("%.2f", static_cast<double>(mCity.getCompany().getSalary(Qualification::NON_QUALIFIED))), "\\d{0,9}(\\.\\d{0,2})?");
+    createLine(publicServiceTab, "Salary of a qualified job: $", format("%.2f", static_cast<double>(mCity.getCompany().getSalary(Qualification::QUALIFIED))), "\\d{0,9}(\\.\\d{0,2})?");
+    createLine(publicServiceTab, "Salary of a highly qualified job: $", format("%.2f", static_cast<double>(mCity.getCompany().getSalary(Qualification::HIGHLY_QUALIFIED))), "\\d{0,9}(\\.\\d{0,2})?");
 
     // Tax policy
     GuiWidget* taxPolicyTab = mGui->createWithDefaultName<GuiWidget>(mStylesheetManager->getStylesheet("windowTabs"));
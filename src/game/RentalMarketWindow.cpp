@@ -36,7 +36,7 @@ RentalMarketWindow::RentalMarketWindow(MessageBus* messageBus, StylesheetManager
     mMessageBus(messageBus), mStylesheetManager(stylesheetManager), mMarket(market), mTable(nullptr)
 {
     mMessageBus->addMailbox(mMailbox);
-    mMarket->subscribe(mMailbox.getId());
+    mMarket->subscribe(mMailbox.getId(), topics(Market<Lease>::Event::Type::ITEM_ADDED, Market<Lease>::Event::Type::ITEM_REMOVED));
 }
 
 RentalMarketWindow::~RentalMarketWindow()
@@ -128,9 +128,9 @@ void RentalMarketWindow::addRow(const Housing* housing, Money rent, int count)
     // Add row
     mTable->addRow({
         mGui->createWithDefaultName<GuiLabel>(housing->getOwner()->getName(), 12, mStylesheetManager->getStylesheet("darkText")),
-        mGui->createWithDefaultName<GuiLabel>(format("%d", housing->getId()), 12, mStylesheetManager->getStylesheet("darkText")),
+        mGui->createWithDefaultName<GuiLabel>(format("%llu", static_cast<unsigned long long>(housing->getId())), 12, mStylesheetManager->getStylesheet("darkText")),
         mGui->createWithDefaultName<GuiLabel>(Tile::typeToString(housing->getType()), 12, mStylesheetManager->getStylesheet("darkText")),
-        mGui->createWithDefaultName<GuiLabel>(format("$%.2f", rent), 12, mStylesheetManager->getStylesheet("darkText")),
+        mGui->createWithDefaultName<GuiLabel>(format("$%.2f", static_cast<double>(rent)), 12, mStylesheetManager->getStylesheet("darkText")),
         mGui->createWithDefaultName<GuiLabel>(format("%d", count), 12, mStylesheetManager->getStylesheet("darkText")),
     });
 }
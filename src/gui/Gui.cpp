@@ -134,6 +134,7 @@ void Gui::remove(GuiWidget* widget)
 
 void Gui::update()
 {
+    removeClosedWindows();
     for (GuiWidget* widget : mRootWidgets)
     {
         if (widget->isDirty())
@@ -185,7 +186,7 @@ void Gui::handleMessages()
                     break;
             }
             event.processed = processed;
-            notify(message);
+            notify(message, topics(event.type));
         }
         else if (message.type == MessageType::GUI)
         {
@@ -193,7 +194,8 @@ void Gui::handleMessages()
             switch (event.type)
             {
                 case GuiEvent::Type::WINDOW_CLOSED:
-                    remove(event.widget);
+                    if (std::find(mClosedWindows.begin(), mClosedWindows.end(), event.widget) == mClosedWindows.end())
+                        mClosedWindows.push_back(event.widget);
                     break;
                 default:
                     break;
@@ -202,6 +204,18 @@ void Gui::handleMessages()
     }
 }
 
+bool Gui::hasClosedWindows() const
+{
+    return !mClosedWindows.empty();
+}
+
+void Gui::removeClosedWindows()
+{
+    for (GuiWidget* window : mClosedWindows)
+        remove(window);
+    mClosedWindows.clear();
+}
+
 const sf::View& Gui::getView()
 {
     return mView;
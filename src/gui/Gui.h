@@ -95,6 +95,9 @@ public:
 
     void update();
     void handleMessages();
+    // Closed windows are removed in update, or before with removeClosedWindows
+    bool hasClosedWindows() const;
+    void removeClosedWindows();
 
     const sf::View& getView();
     void setViewportSize(sf::Vector2u viewportSize);
@@ -112,6 +115,7 @@ private:
     bool mListen;
     std::unordered_map<std::string, std::unique_ptr<GuiWidget>> mWidgets;
     std::vector<GuiWidget*> mRootWidgets;
+    std::vector<GuiWidget*> mClosedWindows;
     unsigned int mCounter; // To generate a name
 
     std::string generateName();
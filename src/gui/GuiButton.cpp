@@ -60,7 +60,7 @@ bool GuiButton::onRelease(sf::Vector2f position, bool processed)
     if (!processed && hitButton(position))
     {
         if (mState == State::PRESSED)
-            notify(Message::create(MessageType::GUI, GuiEvent(this, GuiEvent::Type::BUTTON_RELEASED)));
+            notify(Message::create(MessageType::GUI, GuiEvent(this, GuiEvent::Type::BUTTON_RELEASED)), topics(GuiEvent::Type::BUTTON_RELEASED));
         processed = true;
     }
     if (mState != State::FORCE_PRESSED && mState != State::DISABLED)
@@ -75,7 +75,7 @@ bool GuiWindow::onRelease(sf::Vector2f position, bool processed)
 {
     mOnMove = false;
     if (!processed && mCloseButton.getGlobalBounds().contains(position))
-        notify(Message::create(MessageType::GUI, GuiEvent(this, GuiEvent::Type::WINDOW_CLOSED)));
+        notify(Message::create(MessageType::GUI, GuiEvent(this, GuiEvent::Type::WINDOW_CLOSED)), topics(GuiEvent::Type::WINDOW_CLOSED));
     mCloseButton.setFillColor(mStyle->getFirstChildByName("close").getAttributes().get<sf::Color>("color"));
     return mBackground.getGlobalBounds().contains(position) || mBar.getGlobalBounds().contains(position);
 }
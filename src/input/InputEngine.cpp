@@ -31,7 +31,7 @@ void InputEngine::pollEvents()
 {
     sf::Event event;
     while (mWindow->pollEvent(event))
-        notify(Message::create(MessageType::INPUT, InputEvent(event)));
+        notify(Message::create(MessageType::INPUT, InputEvent(event)), topics(event.type));
 }
 
 bool InputEngine::isKeyPressed(sf::Keyboard::Key key) const
@@ -0,0 +1,37 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "message/Channel.h"
+
+constexpr std::size_t Channel::CAPACITY;
+
+Channel::Channel() : mSequence(0)
+{
+
+}
+
+void Channel::publish(Message message)
+{
+    mMessages.push(message);
+    ++mSequence;
+}
+
+Channel::Cursor Channel::getCursor() const
+{
+    return mSequence;
+}
@@ -0,0 +1,124 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// Boost
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/split_member.hpp>
+// My includes
+#include "util/RingBuffer.h"
+#include "message/Message.h"
+
+/**
+ * \brief Channel to broadcast messages to many receivers at once
+ *
+ * Publishing a message appends it once to the channel instead of putting a
+ * copy in the mailbox of each receiver. Then each reader keeps a cursor and
+ * reads the messages published since its last read.
+ *
+ * Only the last CAPACITY messages are kept. A reader that lags more than
+ * CAPACITY messages behind misses the oldest ones, it is told how many so
+ * that it can recover from the current state of the publisher.
+ *
+ * \see Message
+ *
+ * \author Pierre Vigier
+ */
+class Channel
+{
+public:
+    static constexpr std::size_t CAPACITY = 16; /**< Number of messages kept */
+
+    using Cursor = unsigned int; /**< Sequence number of the next message to read */
+
+    /**
+     * \brief Default constructor
+     */
+    Channel();
+
+    /**
+     * \brief Publish a message
+     *
+     * \param message Message to publish
+     */
+    void publish(Message message);
+
+    /**
+     * \brief Read the messages published since the last read
+     *
+     * If messages were dropped since the last read, onMissed is called
+     * before the callback is called on the messages still kept.
+     *
+     * \param cursor Cursor of the reader, it is advanced past the messages read
+     * \param callback Function called on each message in publication order,
+     * its signature must be void(const Message&)
+     * \param onMissed Function called with the number of messages dropped
+     * before the reader could read them, its signature must be void(std::size_t)
+     */
+    template<typename F, typename G>
+    void read(Cursor& cursor, F callback, G onMissed) const
+    {
+        Cursor oldest = mSequence - mMessages.getSize();
+        if (cursor < oldest)
+        {
+            onMissed(static_cast<std::size_t>(oldest - cursor));
+            cursor = oldest;
+        }
+        for (; cursor != mSequence; ++cursor)
+            callback(mMessages[mMessages.getSize() - (mSequence - cursor)]);
+    }
+
+    /**
+     * \brief Get a cursor on the end of the channel
+     *
+     * \return Cursor that will only read the messages published from now on
+     */
+    Cursor getCursor() const;
+
+private:
+    RingBuffer<Message, CAPACITY> mMessages; /**< Last messages published */
+    Cursor mSequence; /**< Sequence number of the next message published */
+
+    // Serialization
+    friend class boost::serialization::access;
+
+    template<typename Archive>
+    void save(Archive& ar, const unsigned int /*version*/) const
+    {
+        std::size_t size = mMessages.getSize();
+        ar & mSequence & size;
+        for (std::size_t i = 0; i < size; ++i)
+            ar & mMessages[i];
+    }
+
+    template<typename Archive>
+    void load(Archive& ar, const unsigned int /*version*/)
+    {
+        std::size_t size;
+        ar & mSequence & size;
+        mMessages.clear();
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            mMessages.push(Message());
+            ar & mMessages.back();
+        }
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+};
@@ -16,32 +16,98 @@
  */
 
 #include "message/Mailbox.h"
+#include <algorithm>
 
-Mailbox::Mailbox() : mId(UNDEFINED)
+constexpr std::size_t Mailbox::INITIAL_CAPACITY;
+
+Mailbox::Mailbox() : mId(UNDEFINED), mMessages(INITIAL_CAPACITY), mBegin(0), mSize(0),
+    mDrainedBegin(0), mDrainedSize(0), mHighWaterMark(0), mStatistics(nullptr),
+    mConcurrent(false), mPending(nullptr), mNbPuts(0)
+#ifdef MESSAGE_STATISTICS
+    , mTimestamps(INITIAL_CAPACITY)
+#endif
 {
 
 }
 
+Mailbox::~Mailbox()
+{
+    Node* node = mPending.load(std::memory_order_acquire);
+    while (node != nullptr)
+    {
+        Node* next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
 void Mailbox::put(Message message)
 {
-    mMessages.push_back(message);
+    if (mConcurrent)
+    {
+        Node* node = new Node{message, mPending.load(std::memory_order_relaxed)};
+        while (!mPending.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed));
+    }
+    else
+        push(message);
 }
 
 Message Mailbox::get()
 {
-    Message message(mMessages.front());
-    mMessages.pop_front();
+    collect();
+    Message message(mMessages[mBegin]);
+#ifdef MESSAGE_STATISTICS
+    if (mStatistics)
+        mStatistics->onGet(mTimestamps[mBegin]);
+#endif
+    mBegin = (mBegin + 1) & (mMessages.size() - 1);
+    --mSize;
+    if (mSize == 0)
+        forgetSenders();
     return message;
 }
 
 bool Mailbox::isEmpty() const
 {
-    return mMessages.empty();
+    return mSize == 0 && mPending.load(std::memory_order_acquire) == nullptr;
 }
 
 int Mailbox::getNbMessages() const
 {
-    return mMessages.size();
+    int nbMessages = mSize;
+    for (const Node* node = mPending.load(std::memory_order_acquire); node != nullptr; node = node->next)
+        ++nbMessages;
+    return nbMessages;
+}
+
+void Mailbox::push(const Message& message)
+{
+    if (!mCoalescings.empty() && replace(message))
+        return;
+    if (mSize == mMessages.size())
+        grow();
+    mMessages[(mBegin + mSize) & (mMessages.size() - 1)] = message;
+#ifdef MESSAGE_STATISTICS
+    if (mStatistics)
+    {
+        mTimestamps[(mBegin + mSize) & (mMessages.size() - 1)] = mStatistics->getTick();
+        mStatistics->onReceive(message);
+        mStatistics->onPut(mSize + 1);
+    }
+#endif
+    ++mSize;
+    ++mNbPuts;
+    mHighWaterMark = std::max(mHighWaterMark, mSize);
+}
+
+int Mailbox::getHighWaterMark() const
+{
+    return mHighWaterMark;
+}
+
+void Mailbox::resetHighWaterMark()
+{
+    mHighWaterMark = mSize;
 }
 
 Id Mailbox::getId() const
@@ -53,3 +119,109 @@ void Mailbox::setId(Id id)
 {
     mId = id;
 }
+
+void Mailbox::setStatistics(MessageBusStatistics* statistics)
+{
+    mStatistics = statistics;
+}
+
+bool Mailbox::isConcurrent() const
+{
+    return mConcurrent;
+}
+
+void Mailbox::setConcurrent(bool concurrent)
+{
+    collect();
+    mConcurrent = concurrent;
+}
+
+void Mailbox::grow()
+{
+    std::vector<Message> messages(std::max(INITIAL_CAPACITY, 2 * mMessages.size()));
+    std::size_t mask = mMessages.size() - 1;
+    for (std::size_t i = 0; i < mSize; ++i)
+        messages[i] = mMessages[(mBegin + i) & mask];
+    mMessages = std::move(messages);
+#ifdef MESSAGE_STATISTICS
+    std::vector<unsigned int> timestamps(mMessages.size());
+    for (std::size_t i = 0; i < mSize; ++i)
+        timestamps[i] = mTimestamps[(mBegin + i) & mask];
+    mTimestamps = std::move(timestamps);
+#endif
+    mBegin = 0;
+}
+
+void Mailbox::coalesce(MessageType type, unsigned char subtype)
+{
+    mCoalescings.push_back(Coalescing{type, subtype, {}});
+}
+
+bool Mailbox::replace(const Message& message)
+{
+    for (Coalescing& coalescing : mCoalescings)
+    {
+        if (coalescing.type == message.type && coalescing.subtype == message.getSubtype())
+        {
+            // Messages in the ring buffer have sequence numbers in [mNbPuts - mSize, mNbPuts)
+            std::unordered_map<Id, std::size_t>::iterator it = coalescing.lastPuts.find(message.sender);
+            if (it != coalescing.lastPuts.end() && it->second >= mNbPuts - mSize)
+            {
+                mMessages[(mBegin + it->second - (mNbPuts - mSize)) & (mMessages.size() - 1)] = message;
+#ifdef MESSAGE_STATISTICS
+                if (mStatistics)
+                    mStatistics->onCoalesce();
+#endif
+                return true;
+            }
+            coalescing.lastPuts[message.sender] = mNbPuts;
+            return false;
+        }
+    }
+    return false;
+}
+
+void Mailbox::collect()
+{
+    if (!mConcurrent)
+        return;
+    // The list goes from the newest to the oldest message, reverse it
+    Node* node = mPending.exchange(nullptr, std::memory_order_acquire);
+    Node* oldest = nullptr;
+    while (node != nullptr)
+    {
+        Node* next = node->next;
+        node->next = oldest;
+        oldest = node;
+        node = next;
+    }
+    while (oldest != nullptr)
+    {
+        Node* next = oldest->next;
+        push(oldest->message);
+        delete oldest;
+        oldest = next;
+    }
+}
+
+void Mailbox::swapOut()
+{
+    std::swap(mMessages, mDrained);
+    mDrainedBegin = mBegin;
+    mDrainedSize = mSize;
+    if (mMessages.empty())
+        mMessages.resize(INITIAL_CAPACITY);
+#ifdef MESSAGE_STATISTICS
+    std::swap(mTimestamps, mDrainedTimestamps);
+    mTimestamps.resize(mMessages.size());
+#endif
+    mBegin = 0;
+    mSize = 0;
+    forgetSenders();
+}
+
+void Mailbox::forgetSenders()
+{
+    for (Coalescing& coalescing : mCoalescings)
+        coalescing.lastPuts.clear();
+}
@@ -18,16 +18,38 @@
 #pragma once
 
 // STL
+#include <atomic>
 #include <deque>
+#include <unordered_map>
+#include <vector>
 // Boost
 #include <boost/serialization/access.hpp>
+#include <boost/serialization/deque.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/version.hpp>
 // Message
 #include "message/Message.h"
+#include "message/MessageBusStatistics.h"
 
 /**
  * \brief Container specialized in receiving messages
  *
- * Mailbox is a FIFO data structure.
+ * Mailbox is a FIFO data structure. Messages are stored in a growable ring
+ * buffer so that putting and getting messages does not allocate once the
+ * mailbox has reached its usual depth.
+ *
+ * The preferred way to consume messages is drain() which gives access to the
+ * messages by reference instead of copying them one by one.
+ *
+ * A mailbox can be made concurrent. Then, put() can be called from several
+ * threads at the same time. The messages are pushed in a lock-free list and
+ * are moved into the ring buffer by the consumer when it reads the mailbox.
+ * The order of the messages put by a same thread is preserved. The other
+ * methods must still be called from one thread at a time.
+ *
+ * A mailbox can also coalesce messages of some type and sub-type: if a
+ * message of such a type is put while an older message of the same type,
+ * sub-type and sender is still waiting, the older message is replaced.
  *
  * \see Message
  *
@@ -41,9 +63,19 @@ public:
      */
     Mailbox();
 
+    /**
+     * \brief Destructor
+     */
+    ~Mailbox();
+
+    Mailbox(const Mailbox&) = delete;
+    Mailbox& operator=(const Mailbox&) = delete;
+
     /**
      * \brief Put a message
      *
+     * If the mailbox is concurrent, it can be called from any thread.
+     *
      * \param message Message to put in the mailbox
      */
     void put(Message message);
@@ -55,6 +87,36 @@ public:
      */
     Message get();
 
+    /**
+     * \brief Process all the messages
+     *
+     * The messages are swapped out before calling the callback so that it can
+     * safely put new messages in the mailbox. These new messages are processed
+     * before drain returns.
+     *
+     * \param callback Function called on each message in FIFO order, its
+     * signature must be void(Message&)
+     */
+    template<typename F>
+    void drain(F callback)
+    {
+        collect();
+        while (mSize > 0)
+        {
+            swapOut();
+            std::size_t mask = mDrained.size() - 1;
+            for (std::size_t i = 0; i < mDrainedSize; ++i)
+            {
+#ifdef MESSAGE_STATISTICS
+                if (mStatistics)
+                    mStatistics->onGet(mDrainedTimestamps[(mDrainedBegin + i) & mask]);
+#endif
+                callback(mDrained[(mDrainedBegin + i) & mask]);
+            }
+            collect();
+        }
+    }
+
     /**
      * \brief Tell whether or not the mailbox is empty
      *
@@ -69,6 +131,18 @@ public:
      */
     int getNbMessages() const;
 
+    /**
+     * \brief Get the high-water mark
+     *
+     * \return The maximum number of messages in the mailbox since the last reset
+     */
+    int getHighWaterMark() const;
+
+    /**
+     * \brief Reset the high-water mark to the current number of messages
+     */
+    void resetHighWaterMark();
+
     /**
      * \brief Get the id
      *
@@ -83,16 +157,170 @@ public:
      */
     void setId(Id id);
 
+    /**
+     * \brief Set the statistics
+     *
+     * \param statistics Statistics of the message bus the mailbox is
+     * registered in, nullptr to stop recording
+     */
+    void setStatistics(MessageBusStatistics* statistics);
+
+    /**
+     * \brief Tell whether or not the mailbox is concurrent
+     *
+     * \return True if several threads can put messages at the same time, false otherwise
+     */
+    bool isConcurrent() const;
+
+    /**
+     * \brief Set whether or not the mailbox is concurrent
+     *
+     * It must not be called while messages are being put.
+     *
+     * \param concurrent True if several threads can put messages at the same time, false otherwise
+     */
+    void setConcurrent(bool concurrent);
+
+    /**
+     * \brief Coalesce the messages of a type and a sub-type
+     *
+     * Only use it for messages that make obsolete the previous ones of the
+     * same sender. The last message takes the place of the waiting one.
+     *
+     * \param type Type of the messages
+     * \param subtype Sub-type of the messages, see Message::getSubtype
+     */
+    void coalesce(MessageType type, unsigned char subtype);
+
 private:
+    struct Coalescing
+    {
+        MessageType type; /**< Type of the messages to coalesce */
+        unsigned char subtype; /**< Sub-type of the messages to coalesce */
+        std::unordered_map<Id, std::size_t> lastPuts; /**< Sequence number of the last message put by each sender */
+    };
+
+    struct Node
+    {
+        Message message; /**< Message put */
+        Node* next; /**< Node put just before */
+    };
+
+    static constexpr std::size_t INITIAL_CAPACITY = 8;
+
     Id mId; /**< Id */
-    std::deque<Message> mMessages; /**< Queue of messages */
+    std::vector<Message> mMessages; /**< Ring buffer of messages, its size is a power of two */
+    std::size_t mBegin; /**< Index of the oldest message */
+    std::size_t mSize; /**< Number of messages */
+    std::vector<Message> mDrained; /**< Messages being drained, swapped with mMessages to reuse the memory */
+    std::size_t mDrainedBegin; /**< Index of the oldest message being drained */
+    std::size_t mDrainedSize; /**< Number of messages being drained */
+    std::size_t mHighWaterMark; /**< Maximum number of messages */
+    MessageBusStatistics* mStatistics; /**< Statistics of the message bus */
+    bool mConcurrent; /**< True if several threads can put messages at the same time */
+    std::atomic<Node*> mPending; /**< Last message put concurrently and not collected yet */
+    std::vector<Coalescing> mCoalescings; /**< Messages to coalesce */
+    std::size_t mNbPuts; /**< Number of messages put in the ring buffer, used as sequence number */
+#ifdef MESSAGE_STATISTICS
+    std::vector<unsigned int> mTimestamps; /**< Ticks at which the messages were put, parallel to mMessages */
+    std::vector<unsigned int> mDrainedTimestamps; /**< Ticks at which the messages being drained were put */
+#endif
+
+    /**
+     * \brief Put a message in the ring buffer
+     *
+     * \param message Message to put in the ring buffer
+     */
+    void push(const Message& message);
+
+    /**
+     * \brief Replace the waiting message that the message makes obsolete
+     *
+     * \param message Message to put
+     *
+     * \return True if a message was replaced, false if the message must be put
+     */
+    bool replace(const Message& message);
+
+    /**
+     * \brief Double the capacity of the ring buffer
+     */
+    void grow();
+
+    /**
+     * \brief Move the messages put concurrently in the ring buffer
+     */
+    void collect();
+
+    /**
+     * \brief Move the messages to the drained buffer
+     */
+    void swapOut();
+
+    /**
+     * \brief Forget the senders of the coalesced messages
+     *
+     * It must be called when the ring buffer becomes empty, so that the
+     * senders that do not put messages anymore are not kept forever.
+     */
+    void forgetSenders();
 
     // Serialization
     friend class boost::serialization::access;
 
     template<typename Archive>
-    void serialize(Archive& ar, const unsigned int /*version*/)
+    void save(Archive& ar, const unsigned int /*version*/) const
     {
-        ar & mId & mMessages;
+        // Messages put concurrently are saved after the others, in the order they were put
+        std::vector<const Node*> pending;
+        for (const Node* node = mPending.load(std::memory_order_acquire); node != nullptr; node = node->next)
+            pending.push_back(node);
+        std::size_t size = mSize + pending.size();
+        ar & mId & size;
+        // Messages are saved in place so that their addresses are stable
+        std::size_t mask = mMessages.size() - 1;
+        for (std::size_t i = 0; i < mSize; ++i)
+            ar & mMessages[(mBegin + i) & mask];
+        for (auto it = pending.rbegin(); it != pending.rend(); ++it)
+            ar & (*it)->message;
+        ar & mConcurrent;
     }
+
+    template<typename Archive>
+    void load(Archive& ar, const unsigned int version)
+    {
+        mBegin = 0;
+        mSize = 0;
+        ar & mId;
+        if (version == 0)
+        {
+            std::deque<Message> messages;
+            ar & messages;
+            for (const Message& message : messages)
+                put(message);
+        }
+        else
+        {
+            std::size_t size;
+            ar & size;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if (mSize == mMessages.size())
+                    grow();
+                ar & mMessages[mSize];
+                ++mSize;
+            }
+        }
+        if (version >= 2)
+            ar & mConcurrent;
+        mHighWaterMark = mSize;
+        mNbPuts = mSize;
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
 };
+
+// Version 0: messages were saved in a std::deque
+// Version 1: messages are saved one by one
+// Version 2: concurrent flag
+BOOST_CLASS_VERSION(Mailbox, 2)
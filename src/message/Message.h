@@ -18,7 +18,12 @@
 #pragma once
 
 // STL
+#include <cstddef>
+#include <cstring>
 #include <memory>
+#include <new>
+#include <ostream>
+#include <type_traits>
 // My includes
 #include "util/Id.h"
 #include "message/MessageType.h"
@@ -26,8 +31,10 @@
 /**
  * \brief Class that represents a message
  *
- * Note that the memory of the extra info is managed by a std::shared_ptr<void>.
- * If you have an unexpected behavior, check how the memory is managed.
+ * The extra info is stored inline in the message if it is trivially copyable
+ * and fits in INFO_SIZE bytes. Thus sending and copying most messages does not
+ * allocate. Otherwise, the extra info is allocated on the heap and its memory
+ * is managed by a std::shared_ptr<void>.
  *
  * \see Id.h, MessageType.h
  *
@@ -36,10 +43,12 @@
 class Message
 {
 public:
+    static constexpr std::size_t INFO_SIZE = 40; /**< Maximum size of an extra info stored inline */
+    static constexpr std::size_t INFO_ALIGNMENT = alignof(double); /**< Maximum alignment of an extra info stored inline */
+
     Id sender; /**< Sender's id */
     Id receiver; /**< Receiver's id */
     MessageType type; /**< Type of the message */
-    std::shared_ptr<void> info; /**< Extra info */
 
     /**
      * \brief Constructor for message without extra info
@@ -49,71 +58,65 @@ public:
      * \param type Type of the message
      */
     Message(Id sender = UNDEFINED, Id receiver = UNDEFINED, MessageType type = MessageType::UNKNOWN) :
-        sender(sender), receiver(receiver), type(type), info()
+        sender(sender), receiver(receiver), type(type), mStorage(Storage::NONE), mSubtype(0)
     {
 
     }
 
     /**
-     * \brief Constructor for message with extra info
+     * \brief Constructor for message with undefined sender without extra info
      *
-     * \param sender Id of the sender
      * \param receiver Id of the receiver
      * \param type Type of the message
-     * \param info Shared pointer on the extra info
      */
-    Message(Id sender, Id receiver, MessageType type, std::shared_ptr<void> info) :
-        sender(sender), receiver(receiver), type(type), info(info)
+    Message(Id receiver, MessageType type) :
+        sender(UNDEFINED), receiver(receiver), type(type), mStorage(Storage::NONE), mSubtype(0)
     {
 
     }
 
     /**
-     * \brief Constructor for message with undefined sender without extra info
+     * \brief Constructor for message with undefined sender and receiver without extra info
      *
-     * \param receiver Id of the receiver
      * \param type Type of the message
      */
-    Message(Id receiver, MessageType type) :
-        sender(UNDEFINED), receiver(receiver), type(type), info()
+    Message(MessageType type) :
+        sender(UNDEFINED), receiver(UNDEFINED), type(type), mStorage(Storage::NONE), mSubtype(0)
     {
 
     }
 
     /**
-     * \brief Constructor for message with undefined sender and extra info
-     *
-     * \param receiver Id of the receiver
-     * \param type Type of the message
-     * \param info Shared pointer on the extra info
+     * \brief Copy constructor
      */
-    Message(Id receiver, MessageType type, std::shared_ptr<void> info) :
-        sender(UNDEFINED), receiver(receiver), type(type), info(info)
+    Message(const Message& other) :
+        sender(other.sender), receiver(other.receiver), type(other.type), mStorage(Storage::NONE), mSubtype(0)
     {
-
+        copyInfo(other);
     }
 
     /**
-     * \brief Constructor for message with undefined sender and receiver without extra info
-     *
-     * \param type Type of the message
+     * \brief Destructor
      */
-    Message(MessageType type) :
-        sender(UNDEFINED), receiver(UNDEFINED), type(type), info()
+    ~Message()
     {
-
+        resetInfo();
     }
 
     /**
-     * \brief Constructor for message with undefined sender and receiver and extra info
-     *
-     * \param type Type of the message
-     * \param info Shared pointer on the extra info
+     * \brief Copy assignment operator
      */
-    Message(MessageType type, std::shared_ptr<void> info) :
-        sender(UNDEFINED), receiver(UNDEFINED), type(type), info(info)
+    Message& operator=(const Message& other)
     {
-
+        if (this != &other)
+        {
+            sender = other.sender;
+            receiver = other.receiver;
+            type = other.type;
+            resetInfo();
+            copyInfo(other);
+        }
+        return *this;
     }
 
     /**
@@ -139,7 +142,9 @@ public:
     template<typename T>
     static Message create(Id sender, Id receiver, MessageType type, const T& info)
     {
-        return Message(sender, receiver, type, std::make_shared<T>(info));
+        Message message(sender, receiver, type);
+        message.setInfo(info);
+        return message;
     }
 
     /**
@@ -163,7 +168,9 @@ public:
     template<typename T>
     static Message create(Id receiver, MessageType type, const T& info)
     {
-        return Message(receiver, type, std::make_shared<T>(info));
+        Message message(receiver, type);
+        message.setInfo(info);
+        return message;
     }
 
     /**
@@ -185,19 +192,52 @@ public:
     template<typename T>
     static Message create(MessageType type, const T& info)
     {
-        return Message(type, std::make_shared<T>(info));
+        Message message(type);
+        message.setInfo(info);
+        return message;
+    }
+
+    /**
+     * \brief Tell whether an extra info of type T is stored inline
+     *
+     * \return True if the extra info is stored inline, false if it is allocated on the heap
+     */
+    template<typename T>
+    static constexpr bool isInfoInline()
+    {
+        return sizeof(T) <= INFO_SIZE && alignof(T) <= INFO_ALIGNMENT && std::is_trivially_copyable<T>::value;
     }
 
     /**
      * \brief Return true if the message has extra info and false otherwise
      */
-    bool hasInfo()
+    bool hasInfo() const
     {
-        if (info)
-            return true;
-        return false;
+        return mStorage != Storage::NONE;
     }
 
+    /**
+     * \brief Return the sub-type of the message
+     *
+     * \return The type member of the extra info if it has one, 0 otherwise
+     */
+    unsigned char getSubtype() const
+    {
+        return mSubtype;
+    }
+
+    /**
+     * \brief Replace the extra info
+     *
+     * \param info Const reference to the new extra info
+     */
+    template<typename T>
+    void setInfo(const T& info)
+    {
+        resetInfo();
+        setInfo(info, std::integral_constant<bool, isInfoInline<T>()>());
+        mSubtype = computeSubtype(info, 0);
+    }
 
     /**
      * \brief Cast the extra info to the specified type
@@ -205,7 +245,7 @@ public:
     template<typename T>
     inline T& getInfo()
     {
-        return *std::static_pointer_cast<T>(info);
+        return *static_cast<T*>(getInfoPointer());
     }
 
     /**
@@ -214,7 +254,79 @@ public:
     template<typename T>
     inline const T& getInfo() const
     {
-        return *std::static_pointer_cast<T>(info);
+        return *static_cast<const T*>(const_cast<Message*>(this)->getInfoPointer());
+    }
+
+private:
+    enum class Storage : unsigned char {NONE, INLINE, HEAP};
+
+    Storage mStorage; /**< Where the extra info is stored */
+    unsigned char mSubtype; /**< Type of the extra info, used for statistics */
+    alignas(INFO_ALIGNMENT) unsigned char mInfo[INFO_SIZE]; /**< Inline extra info or std::shared_ptr<void> on the heap allocated extra info */
+
+    static_assert(sizeof(std::shared_ptr<void>) <= INFO_SIZE && alignof(std::shared_ptr<void>) <= INFO_ALIGNMENT,
+        "The buffer must be able to contain a std::shared_ptr<void>.");
+
+    template<typename T>
+    void setInfo(const T& info, std::true_type /*inline*/)
+    {
+        new (mInfo) T(info);
+        mStorage = Storage::INLINE;
+    }
+
+    template<typename T>
+    void setInfo(const T& info, std::false_type /*inline*/)
+    {
+        new (mInfo) std::shared_ptr<void>(std::make_shared<T>(info));
+        mStorage = Storage::HEAP;
+    }
+
+    template<typename T>
+    static auto computeSubtype(const T& info, int /*preferred*/) -> decltype(static_cast<unsigned char>(info.type))
+    {
+        return static_cast<unsigned char>(info.type);
+    }
+
+    template<typename T>
+    static unsigned char computeSubtype(const T& /*info*/, long /*fallback*/)
+    {
+        return 0;
+    }
+
+    std::shared_ptr<void>& getHeapInfo()
+    {
+        return *reinterpret_cast<std::shared_ptr<void>*>(mInfo);
+    }
+
+    void* getInfoPointer()
+    {
+        switch (mStorage)
+        {
+            case Storage::INLINE:
+                return mInfo;
+            case Storage::HEAP:
+                return getHeapInfo().get();
+            default:
+                return nullptr;
+        }
+    }
+
+    void copyInfo(const Message& other)
+    {
+        if (other.mStorage == Storage::INLINE)
+            std::memcpy(mInfo, other.mInfo, INFO_SIZE);
+        else if (other.mStorage == Storage::HEAP)
+            new (mInfo) std::shared_ptr<void>(const_cast<Message&>(other).getHeapInfo());
+        mStorage = other.mStorage;
+        mSubtype = other.mSubtype;
+    }
+
+    void resetInfo()
+    {
+        if (mStorage == Storage::HEAP)
+            getHeapInfo().~shared_ptr();
+        mStorage = Storage::NONE;
+        mSubtype = 0;
     }
 };
 
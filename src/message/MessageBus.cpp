@@ -20,7 +20,7 @@
 
 MessageBus::MessageBus()
 {
-
+    mPostedMessages.setConcurrent(true);
 }
 
 void MessageBus::send(Message message)
@@ -28,17 +28,53 @@ void MessageBus::send(Message message)
     if (mMailboxes.has(message.receiver))
         mMailboxes.get(message.receiver)->put(message);
     else
+    {
+#ifdef MESSAGE_STATISTICS
+        mStatistics.onUndelivered();
+#endif
         DEBUG(message << " can't be sent.\n");
+    }
+}
+
+void MessageBus::post(Message message)
+{
+    mPostedMessages.put(std::move(message));
 }
 
-void MessageBus::addMailbox(Mailbox& mailbox)
+void MessageBus::sendPostedMessages()
+{
+    mPostedMessages.drain([this](Message& message)
+    {
+        send(message);
+    });
+}
+
+void MessageBus::addMailbox(Mailbox& mailbox, bool concurrent)
 {
     Id id = mMailboxes.add(&mailbox);
     mailbox.setId(id);
+    mailbox.setStatistics(&mStatistics);
+    mailbox.setConcurrent(concurrent);
 }
 
 void MessageBus::removeMailbox(Mailbox& mailbox)
 {
     mMailboxes.erase(mailbox.getId());
     mailbox.setId(UNDEFINED);
+    mailbox.setStatistics(nullptr);
+}
+
+void MessageBus::tick()
+{
+    mStatistics.tick();
+}
+
+const MessageBusStatistics& MessageBus::getStatistics() const
+{
+    return mStatistics;
+}
+
+void MessageBus::clearStatistics()
+{
+    mStatistics.clear();
 }
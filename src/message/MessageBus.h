@@ -17,9 +17,12 @@
 
 #pragma once
 
+// Boost
+#include <boost/serialization/split_member.hpp>
 // My includes
 #include "util/IdManager.h"
 #include "message/Mailbox.h"
+#include "message/MessageBusStatistics.h"
 
 /**
  * \brief Container for mailboxes that allows them to communicate easily
@@ -40,20 +43,43 @@ public:
      * The receiver of the message must be valid. However the sender can be
      * UNDEFINED.
      *
+     * It can be called from several threads at the same time if the receiver
+     * is a concurrent mailbox and no mailbox is added or removed meanwhile.
+     *
      * Note that the message is pass by value.
      *
      * \param message Message to send
      */
     void send(Message message);
 
+    /**
+     * \brief Post a message to send it later
+     *
+     * It can be called from any thread at the same time as the other methods.
+     * The message is sent by the next call to sendPostedMessages.
+     *
+     * \param message Message to post
+     */
+    void post(Message message);
+
+    /**
+     * \brief Send the messages posted since the last call
+     *
+     * It must be called from the thread that sends the messages. The messages
+     * are sent in the order they were posted by each thread.
+     */
+    void sendPostedMessages();
+
     /**
      * \brief Add a mailbox
      *
      * The mailbox's id is updated.
      *
      * \param mailbox Mailbox to add
+     * \param concurrent True if several threads will send messages to the
+     * mailbox at the same time, see Mailbox::setConcurrent
      */
-    void addMailbox(Mailbox& mailbox);
+    void addMailbox(Mailbox& mailbox, bool concurrent = false);
 
     /**
      * \brief Remove a mailbox
@@ -64,15 +90,46 @@ public:
      */
     void removeMailbox(Mailbox& mailbox);
 
+    /**
+     * \brief Advance the time of the statistics of one tick
+     */
+    void tick();
+
+    /**
+     * \brief Get the statistics
+     *
+     * The statistics are empty if MESSAGE_STATISTICS is not defined.
+     *
+     * \return Statistics on the messages sent through the bus
+     */
+    const MessageBusStatistics& getStatistics() const;
+
+    /**
+     * \brief Reset the statistics
+     */
+    void clearStatistics();
+
 private:
     IdManager<Mailbox*> mMailboxes; /**< IdManager that manages the mailboxes */
+    MessageBusStatistics mStatistics; /**< Statistics */
+    Mailbox mPostedMessages; /**< Concurrent mailbox containing the messages posted and not sent yet */
 
     // Serialization
     friend class boost::serialization::access;
 
     template<typename Archive>
-    void serialize(Archive& ar, const unsigned int /*version*/)
+    void save(Archive& ar, const unsigned int /*version*/) const
     {
         ar & mMailboxes;
     }
+
+    template<typename Archive>
+    void load(Archive& ar, const unsigned int /*version*/)
+    {
+        ar & mMailboxes;
+        for (Mailbox* mailbox : mMailboxes.getObjects())
+            mailbox->setStatistics(&mStatistics);
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
 };
@@ -0,0 +1,159 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "message/MessageBusStatistics.h"
+#include <algorithm>
+
+constexpr std::size_t MessageBusStatistics::NB_TYPES;
+constexpr std::size_t MessageBusStatistics::NB_SUBTYPES;
+constexpr std::size_t MessageBusStatistics::NB_BUCKETS;
+
+MessageBusStatistics::MessageBusStatistics() : mTick(0)
+{
+    clear();
+}
+
+void MessageBusStatistics::onReceive(const Message& message)
+{
+    std::size_t type = std::min(static_cast<std::size_t>(message.type), NB_TYPES - 1);
+    std::size_t subtype = std::min(static_cast<std::size_t>(message.getSubtype()), NB_SUBTYPES - 1);
+    ++mNbMessages[type][subtype];
+}
+
+void MessageBusStatistics::onUndelivered()
+{
+    mNbUndelivered.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MessageBusStatistics::onCoalesce()
+{
+    ++mNbCoalesced;
+}
+
+void MessageBusStatistics::onPut(std::size_t depth)
+{
+    ++mDepths[computeBucket(depth)];
+}
+
+void MessageBusStatistics::onGet(unsigned int putTick)
+{
+    unsigned int latency = mTick - putTick;
+    ++mLatencies[computeBucket(latency)];
+    mTotalLatency += latency;
+    mMaxLatency = std::max(mMaxLatency, latency);
+}
+
+void MessageBusStatistics::tick()
+{
+    ++mTick;
+}
+
+void MessageBusStatistics::clear()
+{
+    for (std::array<unsigned long long, NB_SUBTYPES>& counts : mNbMessages)
+        counts.fill(0);
+    mNbUndelivered = 0;
+    mNbCoalesced = 0;
+    mDepths.fill(0);
+    mLatencies.fill(0);
+    mTotalLatency = 0;
+    mMaxLatency = 0;
+}
+
+unsigned int MessageBusStatistics::getTick() const
+{
+    return mTick;
+}
+
+unsigned long long MessageBusStatistics::getNbMessages(MessageType type) const
+{
+    const std::array<unsigned long long, NB_SUBTYPES>& counts = mNbMessages[std::min(static_cast<std::size_t>(type), NB_TYPES - 1)];
+    unsigned long long nbMessages = 0;
+    for (unsigned long long count : counts)
+        nbMessages += count;
+    return nbMessages;
+}
+
+unsigned long long MessageBusStatistics::getNbMessages(MessageType type, unsigned char subtype) const
+{
+    return mNbMessages[std::min(static_cast<std::size_t>(type), NB_TYPES - 1)][std::min(static_cast<std::size_t>(subtype), NB_SUBTYPES - 1)];
+}
+
+unsigned long long MessageBusStatistics::getNbUndelivered() const
+{
+    return mNbUndelivered.load(std::memory_order_relaxed);
+}
+
+unsigned long long MessageBusStatistics::getNbCoalesced() const
+{
+    return mNbCoalesced;
+}
+
+const MessageBusStatistics::Histogram& MessageBusStatistics::getDepths() const
+{
+    return mDepths;
+}
+
+const MessageBusStatistics::Histogram& MessageBusStatistics::getLatencies() const
+{
+    return mLatencies;
+}
+
+double MessageBusStatistics::getMeanLatency() const
+{
+    unsigned long long nbMessages = 0;
+    for (unsigned long long count : mLatencies)
+        nbMessages += count;
+    if (nbMessages == 0)
+        return 0.0;
+    return static_cast<double>(mTotalLatency) / nbMessages;
+}
+
+unsigned int MessageBusStatistics::getMaxLatency() const
+{
+    return mMaxLatency;
+}
+
+void MessageBusStatistics::writeCsv(std::ostream& os) const
+{
+    os << "type,subtype,messages\n";
+    for (std::size_t type = 0; type < NB_TYPES; ++type)
+    {
+        for (std::size_t subtype = 0; subtype < NB_SUBTYPES; ++subtype)
+        {
+            if (mNbMessages[type][subtype] > 0)
+                os << static_cast<MessageType>(type) << ',' << subtype << ',' << mNbMessages[type][subtype] << '\n';
+        }
+    }
+    os << "undelivered,," << getNbUndelivered() << '\n';
+    os << "coalesced,," << mNbCoalesced << '\n';
+    os << "\nbucket,depths,latencies\n";
+    for (std::size_t i = 0; i < NB_BUCKETS; ++i)
+        os << (i == 0 ? 0ull : 1ull << (i - 1)) << ',' << mDepths[i] << ',' << mLatencies[i] << '\n';
+}
+
+std::size_t MessageBusStatistics::computeBucket(unsigned long long x)
+{
+    std::size_t bucket = 0;
+    while (x > 0 && bucket < NB_BUCKETS - 1)
+    {
+        x >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
@@ -0,0 +1,199 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// STL
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+// My includes
+#include "util/debug.h"
+#include "message/Message.h"
+
+// Statistics are always recorded in debug builds, uncomment to record them in release builds
+//#define MESSAGE_STATISTICS
+#if defined(DEBUG_BUILD) && !defined(MESSAGE_STATISTICS)
+    #define MESSAGE_STATISTICS
+#endif
+
+/**
+ * \brief Statistics on the messages sent through a message bus
+ *
+ * The statistics are only recorded if MESSAGE_STATISTICS is defined.
+ * Otherwise, they stay empty.
+ *
+ * Time is measured in ticks, a tick is a call to MessageBus::tick. Messages
+ * put in a concurrent mailbox are recorded when the consumer collects them.
+ *
+ * Distributions are stored in histograms with power of two buckets: bucket 0
+ * counts the value 0 and bucket i > 0 counts the values in [2^(i-1), 2^i). The
+ * last bucket also counts all the greater values.
+ *
+ * \see MessageBus
+ *
+ * \author Pierre Vigier
+ */
+class MessageBusStatistics
+{
+public:
+    static constexpr std::size_t NB_TYPES = 16; /**< Maximum number of message types */
+    static constexpr std::size_t NB_SUBTYPES = 32; /**< Maximum number of sub-types per message type */
+    static constexpr std::size_t NB_BUCKETS = 16; /**< Number of buckets of the histograms */
+
+    using Histogram = std::array<unsigned long long, NB_BUCKETS>;
+
+    /**
+     * \brief Default constructor
+     */
+    MessageBusStatistics();
+
+    /**
+     * \brief Record a message received by a mailbox
+     *
+     * \param message Message received
+     */
+    void onReceive(const Message& message);
+
+    /**
+     * \brief Record a message whose receiver does not exist
+     *
+     * It can be called from several threads at the same time.
+     */
+    void onUndelivered();
+
+    /**
+     * \brief Record a message dropped because a newer one replaced it
+     */
+    void onCoalesce();
+
+    /**
+     * \brief Record the depth of a mailbox after a message was put in it
+     *
+     * \param depth Number of messages in the mailbox
+     */
+    void onPut(std::size_t depth);
+
+    /**
+     * \brief Record a message taken out of a mailbox
+     *
+     * \param putTick Tick at which the message was put in the mailbox
+     */
+    void onGet(unsigned int putTick);
+
+    /**
+     * \brief Advance the time of one tick
+     */
+    void tick();
+
+    /**
+     * \brief Reset all the statistics except the current tick
+     */
+    void clear();
+
+    /**
+     * \brief Get the current tick
+     *
+     * \return Number of calls to tick since the creation
+     */
+    unsigned int getTick() const;
+
+    /**
+     * \brief Get the number of messages received of a type
+     *
+     * \param type Type of the messages
+     *
+     * \return Number of messages of this type
+     */
+    unsigned long long getNbMessages(MessageType type) const;
+
+    /**
+     * \brief Get the number of messages received of a type and a sub-type
+     *
+     * \param type Type of the messages
+     * \param subtype Sub-type of the messages, see Message::getSubtype
+     *
+     * \return Number of messages of this type and sub-type
+     */
+    unsigned long long getNbMessages(MessageType type, unsigned char subtype) const;
+
+    /**
+     * \brief Get the number of messages whose receiver did not exist
+     *
+     * \return Number of messages not delivered
+     */
+    unsigned long long getNbUndelivered() const;
+
+    /**
+     * \brief Get the number of messages replaced by newer ones
+     *
+     * \return Number of messages coalesced
+     */
+    unsigned long long getNbCoalesced() const;
+
+    /**
+     * \brief Get the distribution of the mailbox depths
+     *
+     * \return Histogram of the depths of the mailboxes after each put
+     */
+    const Histogram& getDepths() const;
+
+    /**
+     * \brief Get the distribution of the latencies
+     *
+     * \return Histogram of the numbers of ticks between enqueue and dequeue
+     */
+    const Histogram& getLatencies() const;
+
+    /**
+     * \brief Get the mean latency
+     *
+     * \return Mean number of ticks between enqueue and dequeue
+     */
+    double getMeanLatency() const;
+
+    /**
+     * \brief Get the maximum latency
+     *
+     * \return Maximum number of ticks between enqueue and dequeue
+     */
+    unsigned int getMaxLatency() const;
+
+    /**
+     * \brief Write the statistics in CSV format
+     *
+     * There is one row per type and sub-type that was sent at least once,
+     * followed by the rows of the histograms.
+     *
+     * \param os Output stream
+     */
+    void writeCsv(std::ostream& os) const;
+
+private:
+    unsigned int mTick; /**< Current tick */
+    std::array<std::array<unsigned long long, NB_SUBTYPES>, NB_TYPES> mNbMessages; /**< Number of messages per type and sub-type */
+    std::atomic<unsigned long long> mNbUndelivered; /**< Number of messages whose receiver did not exist */
+    unsigned long long mNbCoalesced; /**< Number of messages replaced by newer ones */
+    Histogram mDepths; /**< Distribution of depths */
+    Histogram mLatencies; /**< Distribution of latencies */
+    unsigned long long mTotalLatency; /**< Sum of the latencies */
+    unsigned int mMaxLatency; /**< Maximum latency */
+
+    static std::size_t computeBucket(unsigned long long x);
+};
@@ -18,7 +18,9 @@
 #include "message/Subject.h"
 #include "message/MessageBus.h"
 
-Subject::Subject() : mSubjectMessageBus(nullptr)
+constexpr Subject::Topics Subject::ALL_TOPICS;
+
+Subject::Subject() : mSubjectMessageBus(nullptr), mSubjectDeferred(false)
 {
 
 }
@@ -28,27 +30,35 @@ Subject::~Subject()
 
 }
 
-void Subject::setSubjectMessageBus(MessageBus* messageBus)
+void Subject::setSubjectMessageBus(MessageBus* messageBus, bool deferred)
 {
     mSubjectMessageBus = messageBus;
+    mSubjectDeferred = deferred;
 }
 
-void Subject::subscribe(Id id)
+void Subject::subscribe(Id id, Topics topics)
 {
-    mSubscribers.push_back(id);
+    mSubscribers.push_back(Subscriber{id, topics});
 }
 
 void Subject::unsubscribe(Id id)
 {
-    std::vector<Id>::iterator it = std::find(mSubscribers.begin(), mSubscribers.end(), id);
+    std::vector<Subscriber>::iterator it = std::find_if(mSubscribers.begin(), mSubscribers.end(),
+        [id](const Subscriber& subscriber){ return subscriber.id == id; });
     mSubscribers.erase(it);
 }
 
-void Subject::notify(Message message)
+void Subject::notify(Message message, Topics topic)
 {
-    for (const Id& subscriberId : mSubscribers)
+    for (const Subscriber& subscriber : mSubscribers)
     {
-        message.receiver = subscriberId;
-        mSubjectMessageBus->send(message);
+        if (subscriber.topics & topic)
+        {
+            message.receiver = subscriber.id;
+            if (mSubjectDeferred)
+                mSubjectMessageBus->post(message);
+            else
+                mSubjectMessageBus->send(message);
+        }
     }
 }
@@ -18,6 +18,7 @@
 #pragma once
 
 // STL
+#include <cstdint>
 #include <vector>
 #include <algorithm>
 // My includes
@@ -28,11 +29,46 @@ class MessageBus;
 /**
  * \brief Implementation of the Observer design pattern for the messaging system
  *
+ * Each subscriber can restrict the topics it is interested in. A topic is an
+ * event type, for instance City::Event::Type::NEW_CITIZEN. Messages are only
+ * sent to the subscribers interested in their topic.
+ *
  * \author Pierre Vigier
  */
 class Subject
 {
 public:
+    using Topics = std::uint64_t; /**< Bitmask of topics */
+
+    static constexpr Topics ALL_TOPICS = ~Topics(0); /**< Bitmask containing every topic */
+
+    /**
+     * \brief Get the bitmask of a topic
+     *
+     * \param type Event type whose underlying value must be less than 64
+     *
+     * \return Bitmask containing only this topic
+     */
+    template<typename T>
+    static constexpr Topics topics(T type)
+    {
+        return Topics(1) << static_cast<unsigned int>(type);
+    }
+
+    /**
+     * \brief Get the bitmask of several topics
+     *
+     * \param type First event type
+     * \param types Other event types
+     *
+     * \return Bitmask containing these topics
+     */
+    template<typename T, typename... Ts>
+    static constexpr Topics topics(T type, Ts... types)
+    {
+        return topics(type) | topics(types...);
+    }
+
     /**
      * \brief Default constructor
      */
@@ -45,15 +81,21 @@ public:
 
     /**
      * \brief Set the message bus
+     *
+     * \param messageBus Message bus used to notify the subscribers
+     * \param deferred True if the messages must be posted instead of sent,
+     * it allows to notify from another thread than the one of the subscribers,
+     * see MessageBus::post
      */
-    void setSubjectMessageBus(MessageBus* messageBus);
+    void setSubjectMessageBus(MessageBus* messageBus, bool deferred = false);
 
     /**
      * \brief Subscribe a mailbox
      *
      * \param id Id of the mailbox to subscribe
+     * \param topics Topics the mailbox is interested in, all by default
      */
-    void subscribe(Id id);
+    void subscribe(Id id, Topics topics = ALL_TOPICS);
 
     /**
      * \brief Unsubscribe a mailbox
@@ -63,13 +105,21 @@ public:
     void unsubscribe(Id id);
 
     /**
-     * \brief Send a message to every subscribed mailbox
+     * \brief Send a message to every subscribed mailbox interested in its topic
      *
      * \param message Message to send
+     * \param topic Topic of the message, it must contain only one topic
      */
-    void notify(Message message);
+    void notify(Message message, Topics topic);
 
 protected:
+    struct Subscriber
+    {
+        Id id; /**< Id of the subscribed mailbox */
+        Topics topics; /**< Topics the mailbox is interested in */
+    };
+
     MessageBus* mSubjectMessageBus; /**< Message bus */
-    std::vector<Id> mSubscribers; /**< Ids of the subscribed mailboxes */
+    bool mSubjectDeferred; /**< True if the messages are posted instead of sent */
+    std::vector<Subscriber> mSubscribers; /**< Subscribed mailboxes */
 };
@@ -21,12 +21,34 @@
 #include "city/Person.h"
 
 TextFileManager* PersonGenerator::sTextFileManager = nullptr;
-    
+StringTable PersonGenerator::sFirstNames;
+StringTable PersonGenerator::sLastNames;
+StringTable PersonGenerator::sCarModels;
+std::vector<std::uint32_t> PersonGenerator::sMaleFirstNames;
+std::vector<std::uint32_t> PersonGenerator::sFemaleFirstNames;
+std::vector<std::uint32_t> PersonGenerator::sGeneratedLastNames;
+std::vector<std::uint32_t> PersonGenerator::sGeneratedCarModels;
+
 void PersonGenerator::setTextFileManager(TextFileManager* textFileManager)
 {
     sTextFileManager = textFileManager;
 }
 
+StringTable& PersonGenerator::getFirstNames()
+{
+    return sFirstNames;
+}
+
+StringTable& PersonGenerator::getLastNames()
+{
+    return sLastNames;
+}
+
+StringTable& PersonGenerator::getCarModels()
+{
+    return sCarModels;
+}
+
 PersonGenerator::PersonGenerator(RandomGenerator& generator) : mGenerator(generator)
 {
 
@@ -34,10 +56,13 @@ PersonGenerator::PersonGenerator(RandomGenerator& generator) : mGenerator(genera
 
 void PersonGenerator::setUp()
 {
-    mMaleFirstNames = sTextFileManager->loadValues("media/persons/male_first_names.txt");
-    mFemaleFirstNames = sTextFileManager->loadValues("media/persons/female_first_names.txt");
-    mLastNames = sTextFileManager->loadValues("media/persons/last_names.txt");
-    mCars = sTextFileManager->loadValues("media/persons/cars.txt");
+    // The tables are shared by all the generators, they are loaded once
+    if (!sGeneratedCarModels.empty())
+        return;
+    loadValues("media/persons/male_first_names.txt", sFirstNames, sMaleFirstNames);
+    loadValues("media/persons/female_first_names.txt", sFirstNames, sFemaleFirstNames);
+    loadValues("media/persons/last_names.txt", sLastNames, sGeneratedLastNames);
+    loadValues("media/persons/cars.txt", sCarModels, sGeneratedCarModels);
 }
 
 std::unique_ptr<Person> PersonGenerator::generate(int year)
@@ -46,27 +71,15 @@ std::unique_ptr<Person> PersonGenerator::generate(int year)
     std::uniform_int_distribution<int> genderPdf(0, 1);
     Person::Gender gender = static_cast<Person::Gender>(genderPdf(mGenerator));
     // First name
-    std::string firstName;
-    if (gender == Person::Gender::MALE)
-    {
-        std::uniform_int_distribution<std::size_t> firstNamePdf(0, mMaleFirstNames.size() - 1);
-        firstName = mMaleFirstNames[firstNamePdf(mGenerator)];
-    }
-    else
-    {
-        std::uniform_int_distribution<std::size_t> firstNamePdf(0, mFemaleFirstNames.size() - 1);
-        firstName = mFemaleFirstNames[firstNamePdf(mGenerator)];
-    }
+    std::uint32_t firstName = pick(gender == Person::Gender::MALE ? sMaleFirstNames : sFemaleFirstNames);
     // Last name
-    std::uniform_int_distribution<std::size_t> lastNamePdf(0, mLastNames.size() - 1);
-    std::string lastName = mLastNames[lastNamePdf(mGenerator)];
+    std::uint32_t lastName = pick(sGeneratedLastNames);
     // Age
     std::uniform_int_distribution<int> agePdf(20, 60);
     int age = agePdf(mGenerator);
     int birth = year - age;
     // Car
-    std::uniform_int_distribution<std::size_t> carPdf(0, mCars.size() - 1);
-    std::string car = mCars[carPdf(mGenerator)];
+    std::uint32_t car = pick(sGeneratedCarModels);
     // Physiology
     static std::array<float, static_cast<int>(Person::Need::COUNT)> standardDecayRates =
         {0.1f, 0.1f, 0.01f, 0.01f, 0.1f};
@@ -94,19 +107,20 @@ std::string PersonGenerator::generateName()
     std::uniform_int_distribution<int> genderPdf(0, 1);
     Person::Gender gender = static_cast<Person::Gender>(genderPdf(mGenerator));
     // First name
-    std::string firstName;
-    if (gender == Person::Gender::MALE)
-    {
-        std::uniform_int_distribution<std::size_t> firstNamePdf(0, mMaleFirstNames.size() - 1);
-        firstName = mMaleFirstNames[firstNamePdf(mGenerator)];
-    }
-    else
-    {
-        std::uniform_int_distribution<std::size_t> firstNamePdf(0, mFemaleFirstNames.size() - 1);
-        firstName = mFemaleFirstNames[firstNamePdf(mGenerator)];
-    }
+    std::uint32_t firstName = pick(gender == Person::Gender::MALE ? sMaleFirstNames : sFemaleFirstNames);
     // Last name
-    std::uniform_int_distribution<std::size_t> lastNamePdf(0, mLastNames.size() - 1);
-    std::string lastName = mLastNames[lastNamePdf(mGenerator)];
-    return firstName + ' ' + lastName;
+    std::uint32_t lastName = pick(sGeneratedLastNames);
+    return sFirstNames.get(firstName) + ' ' + sLastNames.get(lastName);
+}
+
+void PersonGenerator::loadValues(const std::string& path, StringTable& table, std::vector<std::uint32_t>& indices)
+{
+    for (const std::string& value : sTextFileManager->loadValues(path))
+        indices.push_back(table.add(value));
+}
+
+std::uint32_t PersonGenerator::pick(const std::vector<std::uint32_t>& indices)
+{
+    std::uniform_int_distribution<std::size_t> pdf(0, indices.size() - 1);
+    return indices[pdf(mGenerator)];
 }
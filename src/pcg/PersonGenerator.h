@@ -17,8 +17,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
+#include "util/StringTable.h"
 
 class RandomGenerator;
 class TextFileManager;
@@ -29,6 +31,11 @@ class PersonGenerator
 public:
     static void setTextFileManager(TextFileManager* textFileManager);
 
+    // Names and car models are interned in tables shared by all the persons
+    static StringTable& getFirstNames();
+    static StringTable& getLastNames();
+    static StringTable& getCarModels();
+
     PersonGenerator(RandomGenerator& generator);
 
     void setUp();
@@ -38,9 +45,16 @@ public:
 
 private:
     static TextFileManager* sTextFileManager;
+    static StringTable sFirstNames;
+    static StringTable sLastNames;
+    static StringTable sCarModels;
+    // Indices in the tables of the values that can be generated
+    static std::vector<std::uint32_t> sMaleFirstNames;
+    static std::vector<std::uint32_t> sFemaleFirstNames;
+    static std::vector<std::uint32_t> sGeneratedLastNames;
+    static std::vector<std::uint32_t> sGeneratedCarModels;
     RandomGenerator& mGenerator;
-    std::vector<std::string> mMaleFirstNames;
-    std::vector<std::string> mFemaleFirstNames;
-    std::vector<std::string> mLastNames;
-    std::vector<std::string> mCars;
+
+    static void loadValues(const std::string& path, StringTable& table, std::vector<std::uint32_t>& indices);
+    std::uint32_t pick(const std::vector<std::uint32_t>& indices);
 };
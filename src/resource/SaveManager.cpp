@@ -56,7 +56,7 @@ void SaveManager::tearDown()
 
 }
 
-void SaveManager::save(const City& city, sf::Texture texture)
+void SaveManager::save(City& city, sf::Texture texture)
 {
     const std::string& name = city.getName();
     // Generate a filename if necessary
@@ -75,6 +75,8 @@ void SaveManager::save(const City& city, sf::Texture texture)
         mDocument.addChild(XmlDocument("save", attributes, "", {}));
         updateXmlFile();
     }
+    // Append the new transactions to the journal first so that the save knows how many records the journal has
+    city.getBank().getJournal().spill(path + ".journal");
     // Save the city
     saveCity(city, path);
     // Save the preview
@@ -99,6 +101,8 @@ void SaveManager::removeSave(const std::string& name)
             DEBUG("Failed to delete " << mSaves[name] << "\n");
         if (std::remove((mSaves[name] + ".png").c_str()) != 0)
             DEBUG("Failed to delete " << mSaves[name] + ".png" << "\n");
+        if (std::remove((mSaves[name] + ".journal").c_str()) != 0)
+            DEBUG("Failed to delete " << mSaves[name] + ".journal" << "\n");
         mSaves.erase(name);
         updateXmlFile();
     }
@@ -71,10 +71,13 @@ public:
     /**
      * \brief Save a city
      *
+     * The transactions of the bank since the last save are appended to the
+     * journal file of the save.
+     *
      * \param city City to save
      * \param texture Preview of the city
      */
-    void save(const City& city, sf::Texture texture);
+    void save(City& city, sf::Texture texture);
 
     /**
      * \brief Remove a city
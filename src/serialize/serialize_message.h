@@ -17,12 +17,18 @@
 
 #pragma once
 
+// Boost
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 // City
 #include "city/Bank.h"
 #include "city/Business.h"
 #include "city/City.h"
+#include "city/Good.h"
+#include "city/Lease.h"
 #include "city/Market.h"
 #include "city/Person.h"
+#include "city/Work.h"
 
 // Events
 
@@ -42,9 +48,23 @@ void serialize(Archive& ar, Bank::Event& event, const unsigned int /*version*/)
         case Bank::Event::Type::TRANSFER_MONEY:
             ar & event.transfer.issuer & event.transfer.receiver & event.transfer.amount;
             break;
+        case Bank::Event::Type::TRANSFER_MONEY_BATCH:
+            break;
     }
 }
 
+template<typename Archive>
+void serialize(Archive& ar, Bank::Posting& posting, const unsigned int /*version*/)
+{
+    ar & posting.receiver & posting.amount;
+}
+
+template<typename Archive>
+void serialize(Archive& ar, Bank::TransferMoneyBatchEvent& event, const unsigned int /*version*/)
+{
+    ar & event.issuer & event.postings;
+}
+
 template<typename Archive>
 void serialize(Archive& ar, Business::Event& event, const unsigned int /*version*/)
 {
@@ -102,27 +122,81 @@ void serialize(Archive& ar, Person::Event& event, const unsigned int /*version*/
 // Message
 
 BOOST_SERIALIZATION_SPLIT_FREE(Message)
+// Version 0: the extra info was saved through a std::shared_ptr
+// Version 1: the extra info is saved by value
+BOOST_CLASS_VERSION(Message, 1)
+
+template<typename T, typename Archive>
+void loadInfo(Archive& ar, Message& message)
+{
+    T info;
+    ar & info;
+    message.setInfo(info);
+}
+
+template<typename T, typename Archive>
+void loadSharedInfo(Archive& ar, Message& message)
+{
+    std::shared_ptr<T> info;
+    ar & info;
+    if (info)
+        message.setInfo(*info);
+}
 
 template<typename Archive>
 void save(Archive& ar, const Message& message, const unsigned int /*version*/)
 {
     ar & message.sender & message.receiver & message.type;
+    bool hasInfo = message.hasInfo();
+    ar & hasInfo;
+    if (!hasInfo)
+        return;
     switch (message.type)
     {
         case MessageType::BANK:
-            ar & std::static_pointer_cast<Bank::Event>(message.info);
+        {
+            // The postings of a batch are saved after the base event
+            if (message.getSubtype() == static_cast<unsigned char>(Bank::Event::Type::TRANSFER_MONEY_BATCH))
+            {
+                const Bank::TransferMoneyBatchEvent& batch = message.getInfo<Bank::TransferMoneyBatchEvent>();
+                ar & static_cast<const Bank::Event&>(batch);
+                ar & batch;
+            }
+            else
+                ar & message.getInfo<Bank::Event>();
             break;
+        }
         case MessageType::BUSINESS:
-            ar & std::static_pointer_cast<Business::Event>(message.info);
+            ar & message.getInfo<Business::Event>();
             break;
         case MessageType::CITY:
-            ar & std::static_pointer_cast<City::Event>(message.info);
+            ar & message.getInfo<City::Event>();
             break;
         case MessageType::MARKET:
-            ar & std::static_pointer_cast<MarketBase::EventBase>(message.info);
+        {
+            // The market type is saved first to know the type of the event when loading
+            MarketType marketType = message.getInfo<MarketBase::EventBase>().marketType;
+            ar & marketType;
+            switch (marketType)
+            {
+                case MarketType::NECESSARY_GOOD:
+                case MarketType::NORMAL_GOOD:
+                case MarketType::LUXURY_GOOD:
+                    ar & message.getInfo<Market<Good>::Event>();
+                    break;
+                case MarketType::RENT:
+                    ar & message.getInfo<Market<Lease>::Event>();
+                    break;
+                case MarketType::WORK:
+                    ar & message.getInfo<Market<Work>::Event>();
+                    break;
+                default:
+                    break;
+            }
             break;
+        }
         case MessageType::PERSON:
-            ar & std::static_pointer_cast<Person::Event>(message.info);
+            ar & message.getInfo<Person::Event>();
             break;
         default:
             DEBUG("Message with info of type " << static_cast<int>(message.type) << " is not serializable.");
@@ -131,46 +205,86 @@ void save(Archive& ar, const Message& message, const unsigned int /*version*/)
 }
 
 template<typename Archive>
-void load(Archive& ar, Message& message, const unsigned int /*version*/)
+void load(Archive& ar, Message& message, const unsigned int version)
 {
     ar & message.sender & message.receiver & message.type;
+    if (version == 0)
+    {
+        switch (message.type)
+        {
+            case MessageType::BANK:
+                loadSharedInfo<Bank::Event>(ar, message);
+                break;
+            case MessageType::BUSINESS:
+                loadSharedInfo<Business::Event>(ar, message);
+                break;
+            case MessageType::CITY:
+                loadSharedInfo<City::Event>(ar, message);
+                break;
+            case MessageType::MARKET:
+            {
+                // Only the base of market events was saved, the message can't be processed
+                std::shared_ptr<MarketBase::EventBase> info;
+                ar & info;
+                DEBUG("Market message from an old save dropped.");
+                message.type = MessageType::UNKNOWN;
+                break;
+            }
+            case MessageType::PERSON:
+                loadSharedInfo<Person::Event>(ar, message);
+                break;
+            default:
+                break;
+        }
+        return;
+    }
+    bool hasInfo;
+    ar & hasInfo;
+    if (!hasInfo)
+        return;
     switch (message.type)
     {
         case MessageType::BANK:
         {
-            std::shared_ptr<Bank::Event> info;
-            ar & info;
-            message.info = info;
+            Bank::Event event;
+            ar & event;
+            if (event.type == Bank::Event::Type::TRANSFER_MONEY_BATCH)
+                loadInfo<Bank::TransferMoneyBatchEvent>(ar, message);
+            else
+                message.setInfo(event);
             break;
         }
         case MessageType::BUSINESS:
-        {
-            std::shared_ptr<Business::Event> info;
-            ar & info;
-            message.info = info;
+            loadInfo<Business::Event>(ar, message);
             break;
-        }
         case MessageType::CITY:
-        {
-            std::shared_ptr<City::Event> info;
-            ar & info;
-            message.info = info;
+            loadInfo<City::Event>(ar, message);
             break;
-        }
         case MessageType::MARKET:
         {
-            std::shared_ptr<MarketBase::EventBase> info;
-            ar & info;
-            message.info = info;
+            MarketType marketType;
+            ar & marketType;
+            switch (marketType)
+            {
+                case MarketType::NECESSARY_GOOD:
+                case MarketType::NORMAL_GOOD:
+                case MarketType::LUXURY_GOOD:
+                    loadInfo<Market<Good>::Event>(ar, message);
+                    break;
+                case MarketType::RENT:
+                    loadInfo<Market<Lease>::Event>(ar, message);
+                    break;
+                case MarketType::WORK:
+                    loadInfo<Market<Work>::Event>(ar, message);
+                    break;
+                default:
+                    break;
+            }
             break;
         }
         case MessageType::PERSON:
-        {
-            std::shared_ptr<Person::Event> info;
-            ar & info;
-            message.info = info;
+            loadInfo<Person::Event>(ar, message);
             break;
-        }
         default:
             break;
     }
@@ -17,10 +17,41 @@
  
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 
 /**
  * This definition is particurlarly used by the IdManager
+ *
+ * The IdManager stores the index of a slot in the low 32 bits and the
+ * generation of the slot in the high 32 bits. The bank encodes its accounts
+ * the same way.
  */
-typedef std::size_t Id;
+typedef std::uint64_t Id;
 constexpr Id UNDEFINED = std::numeric_limits<Id>::max();
+constexpr unsigned int ID_SLOT_BITS = 32; /**< Number of bits of an Id used for the slot */
+
+/**
+ * \brief Create the Id of a slot
+ */
+constexpr Id createId(std::size_t slot, std::uint32_t generation)
+{
+    return (static_cast<Id>(generation) << ID_SLOT_BITS) | static_cast<Id>(slot);
+}
+
+/**
+ * \brief Extract the slot from an id
+ */
+constexpr std::size_t getIdSlot(Id id)
+{
+    return static_cast<std::size_t>(id & ((static_cast<Id>(1) << ID_SLOT_BITS) - 1));
+}
+
+/**
+ * \brief Extract the generation from an id
+ */
+constexpr std::uint32_t getIdGeneration(Id id)
+{
+    return static_cast<std::uint32_t>(id >> ID_SLOT_BITS);
+}
@@ -18,15 +18,24 @@
 #pragma once
 
 // STL
+#include <cstdint>
+#include <limits>
 #include <vector>
 // Boost
 #include <boost/serialization/access.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/version.hpp>
 // My includes
 #include "util/Id.h"
 
 /**
  * \brief Container that provides fast-access to elements using Ids
  *
+ * An Id is a generational handle: the index of a slot and the generation of
+ * the slot. The generation is incremented when an element is erased, so an Id
+ * kept after the erasure of its element is never valid again even if the slot
+ * is reused.
+ *
  * \author Pierre Vigier
  */
 template<typename T>
@@ -55,19 +64,21 @@ public:
         // Add object
         std::size_t i = mObjects.size();
         mObjects.push_back(std::move(x));
-        // Get the correct id and set the links
-        Id id;
-        if (mFreeIds.empty())
+        // Get a free slot and set the links
+        std::size_t slot;
+        if (mFreeSlots.empty())
         {
-            id = mIdToIndex.size();
-            mIdToIndex.push_back(i);
+            slot = mSlotToIndex.size();
+            mSlotToIndex.push_back(i);
+            mGenerations.push_back(0);
         }
         else
         {
-            id = mFreeIds.back();
-            mFreeIds.pop_back();
-            mIdToIndex[id] = i;
+            slot = mFreeSlots.back();
+            mFreeSlots.pop_back();
+            mSlotToIndex[slot] = i;
         }
+        Id id = createId(slot, mGenerations[slot]);
         mIndexToId.push_back(id);
         return id;
     }
@@ -75,14 +86,18 @@ public:
     /**
      * \brief Check if an id is present in the container
      *
+     * An id whose element was erased is never present again.
+     *
      * \param id Id to check
      *
      * \return True if the id is present and false otherwise
      */
-     inline bool has(Id id)
-     {
-        return id < mIdToIndex.size() && mIdToIndex[id] != UNDEFINED;
-     }
+    inline bool has(Id id) const
+    {
+        std::size_t slot = getIdSlot(id);
+        return slot < mSlotToIndex.size() && mSlotToIndex[slot] != UNDEFINED_INDEX &&
+            mGenerations[slot] == getIdGeneration(id);
+    }
 
     /**
      * \brief Get an element
@@ -93,7 +108,7 @@ public:
      */
     inline T& get(Id id)
     {
-        return mObjects[mIdToIndex[id]];
+        return mObjects[mSlotToIndex[getIdSlot(id)]];
     }
 
     /**
@@ -105,7 +120,7 @@ public:
      */
     inline const T& get(Id id) const
     {
-        return mObjects[mIdToIndex[id]];
+        return mObjects[mSlotToIndex[getIdSlot(id)]];
     }
 
     /**
@@ -116,19 +131,21 @@ public:
     void erase(Id id)
     {
         // Get the index of the object to destroy
-        std::size_t i = mIdToIndex[id];
+        std::size_t slot = getIdSlot(id);
+        std::size_t i = mSlotToIndex[slot];
         // Swap with the last object and update its index
         mObjects[i] = std::move(mObjects.back());
         Id lastObjectId = mIndexToId.back();
-        mIdToIndex[lastObjectId] = i;
+        mSlotToIndex[getIdSlot(lastObjectId)] = i;
         mIndexToId[i] = lastObjectId;
         // Erase the last object and its index
         mObjects.pop_back();
         mIndexToId.pop_back();
-        // Assign UNDEFINED to the id
-        mIdToIndex[id] = UNDEFINED;
-        // Add the deleted Id to the free Ids
-        mFreeIds.push_back(id);
+        // Invalidate the slot and the ids that refer to it
+        mSlotToIndex[slot] = UNDEFINED_INDEX;
+        ++mGenerations[slot];
+        // Add the slot to the free slots
+        mFreeSlots.push_back(slot);
     }
 
     /**
@@ -162,8 +179,11 @@ public:
     }
 
 private:
-    std::vector<std::size_t> mIdToIndex; /**< std::vector that maps the Id of an element to the index of its index in mObjects */
-    std::vector<Id> mFreeIds; /**< std::vector that contains free Ids */
+    static constexpr std::size_t UNDEFINED_INDEX = std::numeric_limits<std::size_t>::max(); /**< Index of a free slot */
+
+    std::vector<std::size_t> mSlotToIndex; /**< std::vector that maps the slot of an element to its index in mObjects */
+    std::vector<std::uint32_t> mGenerations; /**< std::vector that contains the current generation of each slot */
+    std::vector<std::size_t> mFreeSlots; /**< std::vector that contains free slots */
     std::vector<T> mObjects; /**< std::vector which contains the elements */
     std::vector<Id> mIndexToId; /**< std::vector that maps the index of an element to its Id */
 
@@ -171,8 +191,44 @@ private:
     friend class boost::serialization::access;
 
     template<typename Archive>
-    void serialize(Archive& ar, const unsigned int /*version*/)
+    void save(Archive& ar, const unsigned int /*version*/) const
+    {
+        ar & mSlotToIndex & mFreeSlots & mObjects & mIndexToId & mGenerations;
+    }
+
+    template<typename Archive>
+    void load(Archive& ar, const unsigned int version)
     {
-        ar & mIdToIndex & mFreeIds & mObjects & mIndexToId;
+        ar & mSlotToIndex & mFreeSlots & mObjects & mIndexToId;
+        // Ids of old saves have a null generation
+        if (version >= 1)
+            ar & mGenerations;
+        else
+            mGenerations.assign(mSlotToIndex.size(), 0);
     }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
 };
+
+template<typename T>
+constexpr std::size_t IdManager<T>::UNDEFINED_INDEX;
+
+// Version 0: ids without generation
+// Version 1: generational ids
+namespace boost
+{
+
+namespace serialization
+{
+
+template<typename T>
+struct version<IdManager<T>>
+{
+    typedef mpl::int_<1> type;
+    typedef mpl::integral_c_tag tag;
+    BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+}
+
+}
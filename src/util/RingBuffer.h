@@ -0,0 +1,151 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <array>
+#include <cstddef>
+
+/**
+ * \brief Fixed-capacity circular buffer
+ *
+ * The storage is allocated inline so pushing never allocates. When the buffer
+ * is full, the oldest element is overwritten.
+ *
+ * \author Pierre Vigier
+ */
+template<typename T, std::size_t N>
+class RingBuffer
+{
+public:
+    /**
+     * \brief Default constructor
+     */
+    RingBuffer() : mBegin(0), mSize(0)
+    {
+
+    }
+
+    /**
+     * \brief Add an element
+     *
+     * If the buffer is full, the oldest element is overwritten.
+     *
+     * \param x Element to add
+     */
+    void push(const T& x)
+    {
+        mData[(mBegin + mSize) % N] = x;
+        if (mSize < N)
+            ++mSize;
+        else
+            mBegin = (mBegin + 1) % N;
+    }
+
+    /**
+     * \brief Get an element
+     *
+     * \param i Index of the element, 0 is the oldest element
+     *
+     * \return Reference to the element
+     */
+    inline T& operator[](std::size_t i)
+    {
+        return mData[(mBegin + i) % N];
+    }
+
+    /**
+     * \brief Get an element
+     *
+     * \param i Index of the element, 0 is the oldest element
+     *
+     * \return Const reference to the element
+     */
+    inline const T& operator[](std::size_t i) const
+    {
+        return mData[(mBegin + i) % N];
+    }
+
+    /**
+     * \brief Get the most recent element
+     *
+     * The buffer must not be empty.
+     *
+     * \return Reference to the last element pushed
+     */
+    inline T& back()
+    {
+        return (*this)[mSize - 1];
+    }
+
+    /**
+     * \brief Get the most recent element
+     *
+     * The buffer must not be empty.
+     *
+     * \return Const reference to the last element pushed
+     */
+    inline const T& back() const
+    {
+        return (*this)[mSize - 1];
+    }
+
+    /**
+     * \brief Remove all the elements
+     */
+    void clear()
+    {
+        mBegin = 0;
+        mSize = 0;
+    }
+
+    /**
+     * \brief Tell whether or not the buffer is empty
+     *
+     * \return True if the buffer is empty, false otherwise
+     */
+    inline bool isEmpty() const
+    {
+        return mSize == 0;
+    }
+
+    /**
+     * \brief Return the number of elements
+     *
+     * \return Number of elements in the buffer
+     */
+    inline std::size_t getSize() const
+    {
+        return mSize;
+    }
+
+    /**
+     * \brief Return the capacity
+     *
+     * \return Maximum number of elements in the buffer
+     */
+    static constexpr std::size_t getCapacity()
+    {
+        return N;
+    }
+
+private:
+    std::array<T, N> mData; /**< Storage */
+    std::size_t mBegin; /**< Index of the oldest element */
+    std::size_t mSize; /**< Number of elements */
+};
@@ -0,0 +1,83 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// STL
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \brief Table of interned strings
+ *
+ * Each distinct string is stored once and is designated by its index in the
+ * table. Indices are stable, strings are never removed.
+ *
+ * \author Pierre Vigier
+ */
+class StringTable
+{
+public:
+    /**
+     * \brief Add a string
+     *
+     * If the string is already in the table, it is not added again.
+     *
+     * \param s String to add
+     *
+     * \return Index of the string
+     */
+    std::uint32_t add(const std::string& s)
+    {
+        auto it = mIndices.find(s);
+        if (it != mIndices.end())
+            return it->second;
+        std::uint32_t i = static_cast<std::uint32_t>(mStrings.size());
+        mStrings.push_back(s);
+        mIndices[s] = i;
+        return i;
+    }
+
+    /**
+     * \brief Get a string
+     *
+     * \param i Index of the string
+     *
+     * \return Const reference to the string
+     */
+    inline const std::string& get(std::uint32_t i) const
+    {
+        return mStrings[i];
+    }
+
+    /**
+     * \brief Return the number of strings
+     *
+     * \return Number of strings in the table
+     */
+    inline std::size_t getSize() const
+    {
+        return mStrings.size();
+    }
+
+private:
+    std::vector<std::string> mStrings; /**< Strings */
+    std::unordered_map<std::string, std::uint32_t> mIndices; /**< Index of each string */
+};
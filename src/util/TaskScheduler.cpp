@@ -0,0 +1,315 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "util/TaskScheduler.h"
+#include <algorithm>
+
+TaskScheduler::TaskScheduler(std::size_t nbThreads) : mNbJobs(0), mNbRemainingTasks(0), mStopping(false)
+{
+    startThreads(nbThreads);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    stopThreads();
+}
+
+std::size_t TaskScheduler::getNbThreads() const
+{
+    return mQueues.size();
+}
+
+void TaskScheduler::setNbThreads(std::size_t nbThreads)
+{
+    stopThreads();
+    startThreads(nbThreads);
+}
+
+TaskScheduler::TaskId TaskScheduler::addTask(const std::string& name, std::function<void()> function,
+    std::initializer_list<TaskId> dependencies)
+{
+    TaskId id = createTask(name, dependencies);
+    mTasks[id].function = std::move(function);
+    return id;
+}
+
+TaskScheduler::TaskId TaskScheduler::addParallelTask(const std::string& name, std::function<std::size_t()> getSize,
+    std::size_t chunkSize, std::function<void(std::size_t, std::size_t)> function, std::initializer_list<TaskId> dependencies)
+{
+    TaskId id = createTask(name, dependencies);
+    mTasks[id].getSize = std::move(getSize);
+    mTasks[id].chunkSize = std::max<std::size_t>(chunkSize, 1);
+    mTasks[id].chunkFunction = std::move(function);
+    return id;
+}
+
+void TaskScheduler::run()
+{
+    if (mThreads.empty())
+        runSerially();
+    else
+        runInParallel();
+    recordTimings();
+    mTasks.clear();
+}
+
+const std::vector<TaskScheduler::Timing>& TaskScheduler::getTimings() const
+{
+    return mTimings;
+}
+
+void TaskScheduler::clearTimings()
+{
+    for (Timing& timing : mTimings)
+    {
+        timing.nbRuns = 0;
+        timing.totalTime = std::chrono::nanoseconds::zero();
+        timing.maxTime = std::chrono::nanoseconds::zero();
+    }
+}
+
+void TaskScheduler::writeTimingsCsv(std::ostream& os) const
+{
+    os << "task,runs,total (us),average (us),max (us)\n";
+    for (const Timing& timing : mTimings)
+    {
+        double total = std::chrono::duration<double, std::micro>(timing.totalTime).count();
+        double max = std::chrono::duration<double, std::micro>(timing.maxTime).count();
+        os << timing.name << ',' << timing.nbRuns << ',' << total << ',' <<
+            (timing.nbRuns > 0 ? total / timing.nbRuns : 0.0) << ',' << max << '\n';
+    }
+}
+
+TaskScheduler::TaskId TaskScheduler::createTask(const std::string& name, std::initializer_list<TaskId> dependencies)
+{
+    // Timing
+    auto it = mTimingIndices.find(name);
+    if (it == mTimingIndices.end())
+    {
+        it = mTimingIndices.emplace(name, mTimings.size()).first;
+        mTimings.push_back(Timing{name, 0, std::chrono::nanoseconds::zero(), std::chrono::nanoseconds::zero()});
+    }
+    // Task
+    TaskId id = mTasks.size();
+    mTasks.emplace_back();
+    Task& task = mTasks.back();
+    task.timing = it->second;
+    task.chunkSize = 0;
+    task.nbDependencies = dependencies.size();
+    task.nbPendingDependencies = dependencies.size();
+    task.nbPendingChunks = 0;
+    task.time = 0;
+    // The dependencies are added before so the order of addition is a valid order of execution
+    for (TaskId dependency : dependencies)
+        mTasks[dependency].successors.push_back(id);
+    return id;
+}
+
+void TaskScheduler::startThreads(std::size_t nbThreads)
+{
+    nbThreads = std::max<std::size_t>(nbThreads, 1);
+    mStopping = false;
+    for (std::size_t i = 0; i < nbThreads; ++i)
+        mQueues.push_back(std::make_unique<Queue>());
+    for (std::size_t i = 1; i < nbThreads; ++i)
+        mThreads.emplace_back(&TaskScheduler::work, this, i);
+}
+
+void TaskScheduler::stopThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mCondition.notify_all();
+    for (std::thread& thread : mThreads)
+        thread.join();
+    mThreads.clear();
+    mQueues.clear();
+}
+
+void TaskScheduler::work(std::size_t thread)
+{
+    while (true)
+    {
+        Job job;
+        if (pop(thread, job))
+            execute(thread, job);
+        else
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]{ return mStopping || mNbJobs > 0; });
+            if (mStopping)
+                return;
+        }
+    }
+}
+
+void TaskScheduler::runSerially()
+{
+    for (Task& task : mTasks)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (task.chunkFunction)
+        {
+            std::size_t size = task.getSize();
+            for (std::size_t begin = 0; begin < size; begin += task.chunkSize)
+                task.chunkFunction(begin, std::min(begin + task.chunkSize, size));
+        }
+        else
+            task.function();
+        task.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+void TaskScheduler::runInParallel()
+{
+    if (mTasks.empty())
+        return;
+    mNbRemainingTasks = mTasks.size();
+    // The roots are found before scheduling as a root may complete at once
+    std::vector<TaskId> roots;
+    for (TaskId id = 0; id < mTasks.size(); ++id)
+    {
+        if (mTasks[id].nbDependencies == 0)
+            roots.push_back(id);
+    }
+    for (TaskId id : roots)
+        schedule(0, id);
+    // Work until all the tasks are completed
+    while (mNbRemainingTasks > 0)
+    {
+        Job job;
+        if (pop(0, job))
+            execute(0, job);
+        else
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]{ return mNbJobs > 0 || mNbRemainingTasks == 0; });
+        }
+    }
+}
+
+void TaskScheduler::schedule(std::size_t thread, TaskId id)
+{
+    Task& task = mTasks[id];
+    std::size_t size = 0;
+    std::size_t nbJobs = 1;
+    if (task.chunkFunction)
+    {
+        size = task.getSize();
+        nbJobs = (size + task.chunkSize - 1) / task.chunkSize;
+        // A parallel task without elements is completed at once
+        if (nbJobs == 0)
+        {
+            complete(thread, id);
+            return;
+        }
+        task.nbPendingChunks = nbJobs;
+    }
+    // The counter is changed under the lock so that no thread misses the notification
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mNbJobs += nbJobs;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mQueues[thread]->mutex);
+        if (task.chunkFunction)
+        {
+            for (std::size_t begin = 0; begin < size; begin += task.chunkSize)
+                mQueues[thread]->jobs.push_back(Job{id, begin, std::min(begin + task.chunkSize, size)});
+        }
+        else
+            mQueues[thread]->jobs.push_back(Job{id, 0, 0});
+    }
+    if (nbJobs == 1)
+        mCondition.notify_one();
+    else
+        mCondition.notify_all();
+}
+
+bool TaskScheduler::pop(std::size_t thread, Job& job)
+{
+    // Newest job of the own queue first
+    {
+        Queue& queue = *mQueues[thread];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty())
+        {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+            --mNbJobs;
+            return true;
+        }
+    }
+    // Then the oldest job of another queue
+    for (std::size_t i = 1; i < mQueues.size(); ++i)
+    {
+        Queue& queue = *mQueues[(thread + i) % mQueues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty())
+        {
+            job = queue.jobs.front();
+            queue.jobs.pop_front();
+            --mNbJobs;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::execute(std::size_t thread, const Job& job)
+{
+    Task& task = mTasks[job.task];
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (task.chunkFunction)
+        task.chunkFunction(job.begin, job.end);
+    else
+        task.function();
+    task.time += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    if (!task.chunkFunction || --task.nbPendingChunks == 0)
+        complete(thread, job.task);
+}
+
+void TaskScheduler::complete(std::size_t thread, TaskId id)
+{
+    for (TaskId successor : mTasks[id].successors)
+    {
+        if (--mTasks[successor].nbPendingDependencies == 0)
+            schedule(thread, successor);
+    }
+    if (--mNbRemainingTasks == 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+        }
+        mCondition.notify_all();
+    }
+}
+
+void TaskScheduler::recordTimings()
+{
+    for (const Task& task : mTasks)
+    {
+        Timing& timing = mTimings[task.timing];
+        std::chrono::nanoseconds time(task.time);
+        ++timing.nbRuns;
+        timing.totalTime += time;
+        timing.maxTime = std::max(timing.maxTime, time);
+    }
+}
@@ -0,0 +1,257 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+// My includes
+#include "util/NonCopyable.h"
+#include "util/NonMovable.h"
+
+/**
+ * \brief Scheduler that runs a graph of tasks on a pool of threads
+ *
+ * The graph is built with addTask and addParallelTask, then run executes it
+ * and clears it. A task starts when all its dependencies are completed. A
+ * parallel task is split in chunks that can run at the same time.
+ *
+ * Each thread has its own queue of jobs. A thread takes the last job it pushed
+ * and, when its queue is empty, steals the oldest job of another queue. The
+ * thread that calls run takes part in the work.
+ *
+ * With one thread, no other thread is created and the tasks are executed in
+ * the order in which they were added, the chunks in increasing order. If the
+ * tasks that can run at the same time do not share data, the results are the
+ * same with any number of threads.
+ *
+ * The time spent in each task is recorded. Timings are identified by the
+ * names of the tasks so that they accumulate over the runs.
+ *
+ * \author Pierre Vigier
+ */
+class TaskScheduler : public NonCopyable, public NonMovable
+{
+public:
+    using TaskId = std::size_t; /**< Index of a task in the current graph */
+
+    /**
+     * \brief Time spent in a task over all the runs
+     */
+    struct Timing
+    {
+        std::string name; /**< Name of the task */
+        unsigned long long nbRuns; /**< Number of runs of the task */
+        std::chrono::nanoseconds totalTime; /**< Time spent in the task, summed over the chunks for parallel tasks */
+        std::chrono::nanoseconds maxTime; /**< Longest run */
+    };
+
+    /**
+     * \brief Constructor
+     *
+     * \param nbThreads Number of threads including the one that calls run, 0 is treated as 1
+     */
+    explicit TaskScheduler(std::size_t nbThreads = 1);
+
+    /**
+     * \brief Destructor
+     *
+     * Stop and join the threads.
+     */
+    ~TaskScheduler();
+
+    /**
+     * \brief Get the number of threads
+     *
+     * \return Number of threads including the one that calls run
+     */
+    std::size_t getNbThreads() const;
+
+    /**
+     * \brief Set the number of threads
+     *
+     * It must not be called while a graph is running.
+     *
+     * \param nbThreads Number of threads including the one that calls run, 0 is treated as 1
+     */
+    void setNbThreads(std::size_t nbThreads);
+
+    /**
+     * \brief Add a task to the graph
+     *
+     * \param name Name of the task, used for the timings
+     * \param function Function executed by the task
+     * \param dependencies Tasks that must be completed before this one starts
+     *
+     * \return Id of the task
+     */
+    TaskId addTask(const std::string& name, std::function<void()> function,
+        std::initializer_list<TaskId> dependencies = {});
+
+    /**
+     * \brief Add a task split in chunks to the graph
+     *
+     * The size is only queried when the dependencies are completed so that
+     * they can compute it. The chunks must not share data.
+     *
+     * \param name Name of the task, used for the timings
+     * \param getSize Function that returns the number of elements to process
+     * \param chunkSize Maximum number of elements in a chunk
+     * \param function Function that processes the elements in [begin, end)
+     * \param dependencies Tasks that must be completed before this one starts
+     *
+     * \return Id of the task
+     */
+    TaskId addParallelTask(const std::string& name, std::function<std::size_t()> getSize, std::size_t chunkSize,
+        std::function<void(std::size_t, std::size_t)> function, std::initializer_list<TaskId> dependencies = {});
+
+    /**
+     * \brief Run all the tasks of the graph then clear it
+     *
+     * It returns when all the tasks are completed.
+     */
+    void run();
+
+    /**
+     * \brief Get the timings of the tasks
+     *
+     * \return One timing per task name, in the order in which the names were first used
+     */
+    const std::vector<Timing>& getTimings() const;
+
+    /**
+     * \brief Reset the timings
+     */
+    void clearTimings();
+
+    /**
+     * \brief Write the timings in CSV format
+     *
+     * \param os Stream where to write
+     */
+    void writeTimingsCsv(std::ostream& os) const;
+
+private:
+    struct Task
+    {
+        std::size_t timing;
+        std::function<void()> function;
+        std::function<std::size_t()> getSize;
+        std::size_t chunkSize;
+        std::function<void(std::size_t, std::size_t)> chunkFunction;
+        std::vector<TaskId> successors;
+        std::size_t nbDependencies;
+        std::atomic<std::size_t> nbPendingDependencies;
+        std::atomic<std::size_t> nbPendingChunks;
+        std::atomic<long long> time; // In nanoseconds
+    };
+
+    struct Job
+    {
+        TaskId task;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::deque<Task> mTasks; /**< Tasks of the graph, a deque as tasks can not be moved */
+    std::vector<Timing> mTimings; /**< Timings of the tasks */
+    std::unordered_map<std::string, std::size_t> mTimingIndices; /**< Index of the timing of each name */
+    // Threads
+    std::vector<std::thread> mThreads; /**< Threads that help the one that calls run */
+    std::vector<std::unique_ptr<Queue>> mQueues; /**< Queue of each thread, 0 is the thread that calls run */
+    std::mutex mMutex; /**< Mutex protecting the waits */
+    std::condition_variable mCondition; /**< Signaled when jobs are pushed, when the graph is completed and when stopping */
+    std::atomic<std::size_t> mNbJobs; /**< Number of jobs in the queues */
+    std::atomic<std::size_t> mNbRemainingTasks; /**< Number of tasks of the graph not completed yet */
+    bool mStopping; /**< True if the threads must stop */
+
+    /**
+     * \brief Add a task without function and link it to its dependencies
+     */
+    TaskId createTask(const std::string& name, std::initializer_list<TaskId> dependencies);
+
+    /**
+     * \brief Create the queues and the threads
+     */
+    void startThreads(std::size_t nbThreads);
+
+    /**
+     * \brief Stop and join the threads
+     */
+    void stopThreads();
+
+    /**
+     * \brief Loop of the threads that help the one that calls run
+     */
+    void work(std::size_t thread);
+
+    /**
+     * \brief Execute the tasks in order on the calling thread
+     */
+    void runSerially();
+
+    /**
+     * \brief Execute the tasks with all the threads
+     */
+    void runInParallel();
+
+    /**
+     * \brief Push the jobs of a task whose dependencies are completed in the queue of a thread
+     */
+    void schedule(std::size_t thread, TaskId id);
+
+    /**
+     * \brief Take a job from the queue of a thread or steal one from another queue
+     *
+     * \return True if a job was found, false otherwise
+     */
+    bool pop(std::size_t thread, Job& job);
+
+    /**
+     * \brief Execute a job and complete its task if it was the last job of the task
+     */
+    void execute(std::size_t thread, const Job& job);
+
+    /**
+     * \brief Schedule the successors of a completed task
+     */
+    void complete(std::size_t thread, TaskId id);
+
+    /**
+     * \brief Add the times of the tasks of the graph to the timings
+     */
+    void recordTimings();
+};
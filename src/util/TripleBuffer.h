@@ -0,0 +1,117 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// STL
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+// My includes
+#include "util/NonCopyable.h"
+#include "util/NonMovable.h"
+
+/**
+ * \brief Buffers to hand over values from a producer thread to a consumer thread
+ *
+ * The producer writes in the back buffer then publishes it. The consumer reads
+ * the front buffer and replaces it with the last published one when it wants.
+ * A third buffer holds the last published value so that neither thread waits
+ * for the other: the mutex is only locked to exchange the buffers.
+ *
+ * The buffers are reused, the producer should overwrite the back buffer
+ * without freeing its memory.
+ *
+ * \author Pierre Vigier
+ */
+template<typename T>
+class TripleBuffer : public NonCopyable, public NonMovable
+{
+public:
+    /**
+     * \brief Default constructor
+     */
+    TripleBuffer() : mBack(0), mPublished(1), mFront(2), mFresh(false)
+    {
+
+    }
+
+    /**
+     * \brief Get the back buffer
+     *
+     * It must only be called by the producer.
+     *
+     * \return Reference to the buffer to write
+     */
+    T& getBack()
+    {
+        return mBuffers[mBack];
+    }
+
+    /**
+     * \brief Publish the back buffer
+     *
+     * The back buffer is replaced by the previous published buffer if the
+     * consumer did not take it or by an older buffer otherwise. It must only
+     * be called by the producer.
+     */
+    void publish()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::swap(mBack, mPublished);
+        mFresh = true;
+    }
+
+    /**
+     * \brief Replace the front buffer by the last published buffer
+     *
+     * It must only be called by the consumer.
+     *
+     * \return True if a buffer was published since the last call, false otherwise
+     */
+    bool update()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mFresh)
+            return false;
+        std::swap(mFront, mPublished);
+        mFresh = false;
+        return true;
+    }
+
+    /**
+     * \brief Get the front buffer
+     *
+     * It must only be called by the consumer.
+     *
+     * \return Const reference to the last buffer taken by update
+     */
+    const T& getFront() const
+    {
+        return mBuffers[mFront];
+    }
+
+private:
+    std::array<T, 3> mBuffers; /**< Buffers */
+    std::size_t mBack; /**< Index of the buffer written by the producer */
+    std::size_t mPublished; /**< Index of the last published buffer */
+    std::size_t mFront; /**< Index of the buffer read by the consumer */
+    bool mFresh; /**< True if the published buffer was not taken by the consumer yet */
+    std::mutex mMutex; /**< Mutex protecting the exchanges of buffers */
+};
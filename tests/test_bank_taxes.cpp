@@ -0,0 +1,143 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Check that Bank::collectTaxes gives the same balances as transferring the tax of each account in order
+// and that replaying the journal gives the same balances too
+// Usage: test_bank_taxes [number of accounts]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <random>
+#include <vector>
+#include "message/MessageBus.h"
+#include "city/Bank.h"
+
+namespace
+{
+
+// Former per-account path: each positive income is taxed with a transfer to the city account
+void collectTaxes(std::vector<Money>& balances, std::vector<Money>& previousBalances,
+    const std::vector<Bank::Account::Type>& types, Id cityAccount, double incomeTax, double corporateTax)
+{
+    for (std::size_t i = 0; i < balances.size(); ++i)
+    {
+        double rate = 0.0;
+        if (types[i] == Bank::Account::Type::PERSON)
+            rate = incomeTax;
+        else if (types[i] == Bank::Account::Type::COMPANY)
+            rate = corporateTax;
+        Money income(previousBalances[i] - balances[i]);
+        if (income > 0.0)
+        {
+            Money tax(rate * income);
+            balances[i] -= tax;
+            balances[cityAccount] += tax;
+        }
+        previousBalances[i] = balances[i];
+    }
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t nbAccounts = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    MessageBus messageBus;
+    Mailbox owner;
+    messageBus.addMailbox(owner);
+    Bank bank;
+    bank.setMessageBus(&messageBus);
+
+    // Create the accounts, the ids are given in order
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> fundsDistribution(0.0, 1000.0);
+    std::uniform_real_distribution<double> amountDistribution(0.0, 100.0);
+    std::uniform_int_distribution<std::size_t> accountDistribution(0, nbAccounts - 1);
+    std::bernoulli_distribution typeDistribution(0.9);
+    std::vector<Money> balances;
+    std::vector<Money> previousBalances;
+    std::vector<Bank::Account::Type> types;
+    // The city account is in the middle so that taxes are collected before and after it
+    Id cityAccount = nbAccounts / 2;
+    for (std::size_t i = 0; i < nbAccounts; ++i)
+    {
+        bool person = i != cityAccount && typeDistribution(generator);
+        types.push_back(person ? Bank::Account::Type::PERSON : Bank::Account::Type::COMPANY);
+        balances.emplace_back(fundsDistribution(generator));
+        previousBalances.push_back(balances.back());
+        bank.createAccount(owner.getId(), types.back(), balances.back());
+        owner.drain([](Message&){});
+    }
+    bank.update();
+
+    // Several months to check the rollover of the previous balances too
+    std::size_t nbErrors = 0;
+    for (int month = 0; month < 3; ++month)
+    {
+        for (std::size_t i = 0; i < nbAccounts; ++i)
+        {
+            Id receiver = accountDistribution(generator);
+            Money amount(amountDistribution(generator));
+            bank.transferMoney(i, receiver, amount);
+            balances[i] -= amount;
+            balances[receiver] += amount;
+        }
+        bank.collectTaxes(cityAccount, 0.2, 0.3);
+        collectTaxes(balances, previousBalances, types, cityAccount, 0.2, 0.3);
+        for (std::size_t i = 0; i < nbAccounts; ++i)
+        {
+            if (bank.getBalance(i) != balances[i])
+            {
+                if (nbErrors < 10)
+                    std::printf("Month %d, account %zu: %.17g instead of %.17g\n", month, i,
+                        static_cast<double>(bank.getBalance(i)), static_cast<double>(balances[i]));
+                ++nbErrors;
+            }
+        }
+    }
+    std::printf("%zu accounts, %zu different balances\n", nbAccounts, nbErrors);
+
+    // Replay the journal, the ids are the slots as no account was closed
+    const std::string path = "test_bank_taxes.journal";
+    std::vector<Money> replayedBalances;
+    std::size_t nbRecords = 0;
+    std::size_t nbReplayErrors = 0;
+    if (!bank.getJournal().spill(path) || !Journal::replay(path, replayedBalances, nbRecords) ||
+        replayedBalances.size() != nbAccounts)
+    {
+        std::printf("Fail to replay the journal\n");
+        nbReplayErrors = 1;
+    }
+    else
+    {
+        for (std::size_t i = 0; i < nbAccounts; ++i)
+        {
+            if (replayedBalances[i] != bank.getBalance(i))
+            {
+                if (nbReplayErrors < 10)
+                    std::printf("Replay, account %zu: %.17g instead of %.17g\n", i,
+                        static_cast<double>(replayedBalances[i]), static_cast<double>(bank.getBalance(i)));
+                ++nbReplayErrors;
+            }
+        }
+        std::printf("%zu records replayed, %zu different balances\n", nbRecords, nbReplayErrors);
+    }
+    std::remove(path.c_str());
+    return nbErrors == 0 && nbReplayErrors == 0 ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Check that the cars moved along their path without steering arrive at the same time as the steered ones
+// Usage: test_car_paths
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "ai/Kinematic.h"
+#include "ai/SteeringBehaviors.h"
+
+namespace
+{
+
+constexpr float DT = 1.0f / 60.0f;
+constexpr float TOLERANCE = 0.025f; // Relative difference of the arrival times
+constexpr int MAX_NB_STEPS = 100000;
+
+// Same parameters as Car
+struct TestCar
+{
+    Kinematic kinematic;
+    SteeringBehaviors steering;
+
+    TestCar(const std::vector<Vector2f>& points) : kinematic(1.0f, 150.0f), steering(&kinematic)
+    {
+        kinematic.setPosition(points.front());
+        steering.setSeekDistance(4.0f);
+        steering.setArriveDistance(4.0f);
+        steering.setPath(Path(points));
+    }
+
+    // The steered cars slow down near the last point, the others stop on it
+    bool hasArrived(bool steered) const
+    {
+        const Path& path = steering.getPath();
+        if (steered)
+            return path.isFinished() && kinematic.getPosition().squaredDistanceTo(path.getLastPoint()) < 1.0f;
+        return path.isFinished() && kinematic.getPosition().almostEquals(path.getLastPoint()) && kinematic.getVelocity().isAlmostZero();
+    }
+};
+
+// Zig-zag between the roads, with segments of increasing length
+std::vector<Vector2f> createZigZag(int nbPoints)
+{
+    std::vector<Vector2f> points;
+    for (int i = 0; i < nbPoints; ++i)
+        points.emplace_back(64.0f * i, 32.0f * (i % 2 ? i : -i));
+    return points;
+}
+
+// Return the number of steps to arrive, MAX_NB_STEPS if the car never arrives
+int drive(TestCar& car, bool steered)
+{
+    int nbSteps = 0;
+    while (!car.hasArrived(steered) && nbSteps < MAX_NB_STEPS)
+    {
+        if (steered)
+        {
+            car.kinematic.addForce(car.steering.compute(DT));
+            car.kinematic.update(DT);
+        }
+        else
+            car.steering.advanceAlongPath(DT);
+        ++nbSteps;
+    }
+    return nbSteps;
+}
+
+}
+
+int main()
+{
+    int nbFailures = 0;
+    for (int nbPoints : {2, 3, 5, 10, 20, 30})
+    {
+        std::vector<Vector2f> points = createZigZag(nbPoints);
+        TestCar steeredCar(points);
+        TestCar walkingCar(points);
+        int nbSteeringSteps = drive(steeredCar, true);
+        int nbWalkingSteps = drive(walkingCar, false);
+        float ratio = static_cast<float>(nbWalkingSteps) / nbSteeringSteps;
+        bool success = nbSteeringSteps < MAX_NB_STEPS && nbWalkingSteps < MAX_NB_STEPS && std::abs(ratio - 1.0f) <= TOLERANCE;
+        std::printf("%2d points: %.3f s with steering, %.3f s along the path, ratio %.4f%s\n", nbPoints,
+            nbSteeringSteps * DT, nbWalkingSteps * DT, ratio, success ? "" : " FAILED");
+        if (!success)
+            ++nbFailures;
+    }
+    return nbFailures > 0 ? 1 : 0;
+}
@@ -0,0 +1,65 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Time the Money arithmetic of the bank, build with and without FIXED_POINT_MONEY to compare
+// Usage: benchmark_money [number of accounts]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "city/Money.h"
+
+int main(int argc, char* argv[])
+{
+    std::size_t nbAccounts = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> distribution(0.0, 1000.0);
+    std::vector<Money> balances(nbAccounts);
+    std::vector<Money> amounts(nbAccounts);
+    for (std::size_t i = 0; i < nbAccounts; ++i)
+    {
+        balances[i] = distribution(generator);
+        amounts[i] = distribution(generator);
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Money total(0.0);
+    for (int k = 0; k < 100; ++k)
+    {
+        // Transfers and taxes
+        for (std::size_t i = 0; i < nbAccounts; ++i)
+        {
+            Money tax(0.1 * amounts[i]);
+            balances[i] += amounts[i];
+            balances[i] -= tax;
+            total += tax;
+        }
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+#ifdef FIXED_POINT_MONEY
+    const char* representation = "fixed point";
+#else
+    const char* representation = "double";
+#endif
+    std::printf("%s: %.3f ns per account (total %.4f)\n", representation, duration.count() * 1e9 / (100 * nbAccounts),
+        static_cast<double>(total));
+    return 0;
+}
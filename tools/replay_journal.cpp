@@ -0,0 +1,41 @@
+/* Simulopolis
+ * Copyright (C) 2018 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Rebuild the balances of the accounts from the journal of a save
+// Usage: replay_journal saves/<name>.city.journal
+
+#include <cstdio>
+#include <vector>
+#include "city/Journal.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "Usage: %s journal\n", argv[0]);
+        return 1;
+    }
+    std::vector<Money> balances;
+    std::size_t nbRecords = 0;
+    if (!Journal::replay(argv[1], balances, nbRecords))
+        return 1;
+    std::printf("%zu records\n", nbRecords);
+    for (std::size_t account = 0; account < balances.size(); ++account)
+        std::printf("%zu %.17g\n", account, static_cast<double>(balances[account]));
+    return 0;
+}